@@ -0,0 +1,174 @@
+#include "dynamixel/Dynamixel.h"
+#include "dynamixel/FaultInjectingTransport.h"
+#include "dynamixel/MemoryTransport.h"
+#include "dynamixel/SerialPort.h"
+
+#include <boost/log/core.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace goliath::dynamixel;
+
+/**
+ * Measures the effective throughput and latency of *present position* reads, including the retries of
+ * `Dynamixel::trySend()`, while a `FaultInjectingTransport` corrupts the bus at increasing error rates.
+ * By default the bus is a simulated unit behind a `MemoryTransport`, so the results only show what the recovery
+ * costs; pass a serial device to measure a real bus.
+ *
+ * Usage: recovery-benchmark [transactions [device id [baud]]]
+ */
+namespace {
+    using Clock = Transport::Clock;
+
+    constexpr Dynamixel::byte SimulatedId = 1;
+
+    struct Report {
+        FaultInjectingTransport::Faults faults;
+        FaultInjectingTransport::Statistics injected;
+        size_t transactions = 0;
+        // Transactions that returned a value, possibly after retries.
+        size_t succeeded = 0;
+        // Successful transactions per second.
+        double throughput = 0.0;
+        // Latency percentiles of all transactions.
+        Clock::duration median{};
+        Clock::duration p99{};
+        Clock::duration p999{};
+        Clock::duration max{};
+    };
+
+    /**
+     * Answers every instruction like an AX-12 at position 512; reads return zeros past the position.
+     */
+    std::vector<Dynamixel::byte> simulate(const Dynamixel::byte *data, size_t size) {
+        if (size < 6 || data[2] != SimulatedId) {
+            return {};
+        }
+
+        // [0xFF, 0xFF, ID, LENGTH, ERROR, PARAMETERS..., CHECKSUM]
+        std::vector<Dynamixel::byte> statusPacket = {0xFF, 0xFF, SimulatedId, 2, 0};
+        if (data[4] == static_cast<Dynamixel::byte>(Dynamixel::Instruction::Read) && size >= 8) {
+            size_t length = data[6];
+            statusPacket[3] = static_cast<Dynamixel::byte>(2 + length);
+            statusPacket.resize(5 + length, 0);
+            if (data[5] == static_cast<Dynamixel::byte>(Dynamixel::Address::PresentPosition) && length >= 2) {
+                statusPacket[5] = 0x00;
+                statusPacket[6] = 0x02;
+            }
+        }
+        statusPacket.push_back(Utils::checkSum(statusPacket));
+
+        return statusPacket;
+    }
+
+    Clock::duration percentile(const std::vector<Clock::duration> &sorted, double fraction) {
+        if (sorted.empty()) {
+            return {};
+        }
+
+        auto index = static_cast<size_t>(fraction * static_cast<double>(sorted.size()));
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+
+    double toMilliseconds(Clock::duration duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+    /**
+     * Read the present position of a unit through a fault injecting transport.
+     * @param transport the transport of the bus.
+     * @param id the ID of the unit to read.
+     * @param faults the faults to inject.
+     * @param transactions the number of reads.
+     * @param tries how many times a read is retried after an error.
+     * @param seed the seed of the fault injection.
+     * @return the results.
+     */
+    Report run(std::shared_ptr<Transport> transport, Dynamixel::byte id, const FaultInjectingTransport::Faults &faults,
+               size_t transactions, int tries = 5, uint32_t seed = 0) {
+        auto faultyTransport = std::make_shared<FaultInjectingTransport>(std::move(transport), faults, seed);
+        Dynamixel servo(id, faultyTransport);
+        // Flipped error bits would flood the default monitor with made up errors.
+        servo.setErrorMonitor(nullptr);
+
+        Report report;
+        report.faults = faults;
+        report.transactions = transactions;
+
+        std::vector<Clock::duration> latencies;
+        latencies.reserve(transactions);
+
+        auto start = Clock::now();
+        for (size_t i = 0; i < transactions; ++i) {
+            auto begin = Clock::now();
+            Result<std::vector<Dynamixel::byte>> result = servo.tryReadBlock(Dynamixel::Address::PresentPosition,
+                                                                             2, tries);
+            latencies.push_back(Clock::now() - begin);
+
+            if (result) {
+                ++report.succeeded;
+            }
+        }
+        auto elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+        std::sort(latencies.begin(), latencies.end());
+        report.injected = faultyTransport->getStatistics();
+        report.throughput = elapsed > 0.0 ? static_cast<double>(report.succeeded) / elapsed : 0.0;
+        report.median = percentile(latencies, 0.5);
+        report.p99 = percentile(latencies, 0.99);
+        report.p999 = percentile(latencies, 0.999);
+        report.max = latencies.empty() ? Clock::duration() : latencies.back();
+
+        return report;
+    }
+
+    void print(const Report &report) {
+        std::printf("%-8.4f %-8.4f %-8.4f %-8.4f %-8.4f %-10.0f %-8.3f %-8.3f %-8.3f %.3f\n",
+                    report.faults.bitFlipRate, report.faults.dropRate, report.faults.strayRate,
+                    report.faults.silentRate,
+                    report.transactions > 0 ? static_cast<double>(report.succeeded) / report.transactions : 0.0,
+                    report.throughput, toMilliseconds(report.median), toMilliseconds(report.p99),
+                    toMilliseconds(report.p999), toMilliseconds(report.max));
+    }
+}
+
+int main(int argc, char **argv) {
+    size_t transactions = argc > 1 ? std::stoul(argv[1]) : 10000;
+
+    std::shared_ptr<Transport> transport;
+    Dynamixel::byte id = SimulatedId;
+    if (argc > 3) {
+        auto port = std::make_shared<SerialPort>();
+        if (!port->connect(argv[2], argc > 4 ? static_cast<unsigned int>(std::stoul(argv[4])) : 1000000)) {
+            std::cerr << "Couldn't open " << argv[2] << std::endl;
+            return EXIT_FAILURE;
+        }
+        transport = port;
+        id = static_cast<Dynamixel::byte>(std::stoul(argv[3]));
+    } else {
+        // The timeout dominates the cost of lost replies.
+        transport = std::make_shared<MemoryTransport>(simulate);
+        transport->setTimeout(std::chrono::milliseconds(2));
+    }
+
+    // Every retry would be logged otherwise.
+    boost::log::core::get()->set_logging_enabled(false);
+
+    FaultInjectingTransport::Faults faults;
+    faults.bitFlipRate = 0.001;
+    faults.dropRate = 0.0005;
+    faults.strayRate = 0.0005;
+    faults.delayRate = 0.001;
+    faults.delay = std::chrono::milliseconds(1);
+    faults.silentRate = 0.001;
+
+    std::printf("flip/B   drop/B   stray/B  silent   success  trans/s    p50 ms   p99 ms   p99.9 ms max ms\n");
+    for (double scale : {0.0, 1.0, 5.0, 20.0, 50.0}) {
+        print(run(transport, id, faults.scaled(scale), transactions));
+    }
+
+    return EXIT_SUCCESS;
+}
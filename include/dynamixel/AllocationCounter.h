@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <dlfcn.h>
+#include <pthread.h>
+
+namespace goliath::dynamixel {
+    /**
+     * Counts the heap allocations and the lock acquisitions of watched threads, to verify that a real-time loop
+     * neither allocates nor takes locks once it runs (see `RealTimeWorker`). Counting requires the hook: put
+     * `GOLIATH_DYNAMIXEL_ALLOCATION_HOOK()` at namespace scope in exactly one source file of the program (e.g. a
+     * test or benchmark), and link it with `${CMAKE_DL_LIBS}`. Without it nothing is counted and `isInstalled()`
+     * returns false.
+     *
+     * The hook interposes the malloc family of glibc, which every overload of `operator new` allocates through,
+     * and the blocking mutex and read-write lock functions of pthreads (which `std::mutex` and friends lock
+     * through). Locks internal to glibc, such as those of malloc itself, aren't seen.
+     */
+    class AllocationCounter {
+    public:
+        /**
+         * @return true if the hook is part of the program; otherwise, false.
+         */
+        static bool isInstalled();
+
+        /**
+         * Start or stop counting the allocations and locks of the calling thread.
+         * @param watch whether to count.
+         * @param trap abort the program on the first allocation or lock while watched, to get a core dump of the
+         * culprit.
+         */
+        static void watch(bool watch, bool trap = false);
+
+        /**
+         * @return the number of allocations of watched threads so far.
+         */
+        static uint64_t getCount();
+
+        /**
+         * @return the number of allocations of the calling thread while it was watched.
+         */
+        static uint64_t getThreadCount();
+
+        /**
+         * @return the number of locks taken by watched threads so far.
+         */
+        static uint64_t getLockCount();
+
+        /**
+         * @return the number of locks taken by the calling thread while it was watched.
+         */
+        static uint64_t getThreadLockCount();
+
+        /**
+         * Called by the hook on every allocation.
+         */
+        static void record() noexcept;
+
+        /**
+         * Called by the hook on every lock.
+         */
+        static void recordLock() noexcept;
+
+        /**
+         * Called by the hook when the program starts.
+         * @return true.
+         */
+        static bool install() noexcept;
+    };
+}
+
+extern "C" {
+void *__libc_malloc(std::size_t size);
+void *__libc_calloc(std::size_t count, std::size_t size);
+void *__libc_realloc(void *memory, std::size_t size);
+void *__libc_memalign(std::size_t alignment, std::size_t size);
+void *__libc_valloc(std::size_t size);
+void *__libc_pvalloc(std::size_t size);
+}
+
+/**
+ * Replaces the allocation and locking functions by counting ones; see `AllocationCounter`.
+ * The locking functions forward to the next definition, which is looked up on their first call.
+ */
+#define GOLIATH_DYNAMIXEL_ALLOCATION_HOOK()                                                                     \
+    extern "C" void *malloc(std::size_t size) noexcept {                                                       \
+        goliath::dynamixel::AllocationCounter::record();                                                       \
+        return __libc_malloc(size);                                                                            \
+    }                                                                                                          \
+    extern "C" void *calloc(std::size_t count, std::size_t size) noexcept {                                    \
+        goliath::dynamixel::AllocationCounter::record();                                                       \
+        return __libc_calloc(count, size);                                                                     \
+    }                                                                                                          \
+    extern "C" void *realloc(void *memory, std::size_t size) noexcept {                                        \
+        goliath::dynamixel::AllocationCounter::record();                                                       \
+        return __libc_realloc(memory, size);                                                                   \
+    }                                                                                                          \
+    extern "C" void *memalign(std::size_t alignment, std::size_t size) noexcept {                              \
+        goliath::dynamixel::AllocationCounter::record();                                                       \
+        return __libc_memalign(alignment, size);                                                               \
+    }                                                                                                          \
+    extern "C" void *aligned_alloc(std::size_t alignment, std::size_t size) noexcept {                         \
+        return memalign(alignment, size);                                                                      \
+    }                                                                                                          \
+    extern "C" int posix_memalign(void **memory, std::size_t alignment, std::size_t size) noexcept {           \
+        if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0) {                           \
+            return EINVAL;                                                                                     \
+        }                                                                                                      \
+        void *allocated = memalign(alignment, size);                                                           \
+        if (allocated == nullptr) {                                                                            \
+            return ENOMEM;                                                                                     \
+        }                                                                                                      \
+        *memory = allocated;                                                                                   \
+        return 0;                                                                                              \
+    }                                                                                                          \
+    extern "C" void *valloc(std::size_t size) noexcept {                                                       \
+        goliath::dynamixel::AllocationCounter::record();                                                       \
+        return __libc_valloc(size);                                                                            \
+    }                                                                                                          \
+    extern "C" void *pvalloc(std::size_t size) noexcept {                                                      \
+        goliath::dynamixel::AllocationCounter::record();                                                       \
+        return __libc_pvalloc(size);                                                                           \
+    }                                                                                                          \
+    extern "C" int pthread_mutex_lock(pthread_mutex_t *mutex) noexcept {                                       \
+        static const auto next = reinterpret_cast<int (*)(pthread_mutex_t *)>(                                 \
+                dlsym(RTLD_NEXT, "pthread_mutex_lock"));                                                       \
+        goliath::dynamixel::AllocationCounter::recordLock();                                                   \
+        return next(mutex);                                                                                    \
+    }                                                                                                          \
+    extern "C" int pthread_rwlock_rdlock(pthread_rwlock_t *lock) noexcept {                                    \
+        static const auto next = reinterpret_cast<int (*)(pthread_rwlock_t *)>(                                \
+                dlsym(RTLD_NEXT, "pthread_rwlock_rdlock"));                                                    \
+        goliath::dynamixel::AllocationCounter::recordLock();                                                   \
+        return next(lock);                                                                                     \
+    }                                                                                                          \
+    extern "C" int pthread_rwlock_wrlock(pthread_rwlock_t *lock) noexcept {                                    \
+        static const auto next = reinterpret_cast<int (*)(pthread_rwlock_t *)>(                                \
+                dlsym(RTLD_NEXT, "pthread_rwlock_wrlock"));                                                    \
+        goliath::dynamixel::AllocationCounter::recordLock();                                                   \
+        return next(lock);                                                                                     \
+    }                                                                                                          \
+    static const bool goliathDynamixelAllocationHook = goliath::dynamixel::AllocationCounter::install();
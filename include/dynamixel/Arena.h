@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace goliath::dynamixel {
+    /**
+     * A fixed block of memory that objects are carved from, and only released as a whole. The block is allocated
+     * and touched up front, so with locked memory (`mlockall()`) the objects never page fault or reach `malloc()`.
+     */
+    class Arena {
+    public:
+        /**
+         * @param capacity the size of the block in bytes.
+         */
+        explicit Arena(size_t capacity);
+
+        Arena(const Arena &) = delete;
+
+        Arena &operator=(const Arena &) = delete;
+
+        /**
+         * Carve value-initialized objects from the block.
+         * @param count the number of objects.
+         * @return the first object.
+         * @throws std::bad_alloc if the block is exhausted.
+         */
+        template<typename T>
+        T *allocate(size_t count) {
+            static_assert(std::is_trivially_destructible<T>::value, "arena objects are never destroyed");
+
+            size_t offset = (used + alignof(T) - 1) / alignof(T) * alignof(T);
+            if (offset + count * sizeof(T) > capacity) {
+                throw std::bad_alloc();
+            }
+            used = offset + count * sizeof(T);
+
+            T *objects = reinterpret_cast<T *>(memory.get() + offset);
+            for (size_t i = 0; i < count; ++i) {
+                new(objects + i) T();
+            }
+
+            return objects;
+        }
+
+        /**
+         * @return the number of bytes used.
+         */
+        size_t size() const;
+
+        /**
+         * @return the size of the block in bytes.
+         */
+        size_t getCapacity() const;
+
+    private:
+        std::unique_ptr<unsigned char[]> memory;
+        size_t capacity;
+        size_t used = 0;
+    };
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+// Boost 1.74's awaitable.hpp uses std::exchange without including <utility>.
+#include <utility>
+
+#include "Dynamixel.h"
+#include "SerialPort.h"
+#include <boost/asio/awaitable.hpp>
+#include <deque>
+
+namespace goliath::dynamixel {
+    /**
+     * Serializes coroutine transactions on the io_service of a serial port.
+     * Any number of tasks can await transactions concurrently; they're performed one after another, in the order
+     * they were requested. All tasks must run on the io_service of the serial port (`SerialPort::getIoService()`),
+     * which must not be used for the blocking API at the same time.
+     */
+    class AsyncBus {
+    public:
+        using byte = Dynamixel::byte;
+
+        explicit AsyncBus(std::shared_ptr<SerialPort> port);
+
+        /**
+         * Send an instruction packet and receive the status packet, without blocking the thread.
+         * @param id the ID of the addressed Dynamixel unit.
+         * @param instruction the instruction for the Dynamixel actuator to perform.
+         * @param data a vector of bytes containing the packet's parameters.
+         * @param tries how many times the transaction is retried after an error.
+         * @return the status packet (without checksum), or the error of the last try.
+         */
+        boost::asio::awaitable<Result<std::vector<byte>>> transact(byte id, Dynamixel::Instruction instruction,
+                                                                   std::vector<byte> data, int tries = 5);
+
+        /**
+         * @return the serial port of the bus.
+         */
+        std::shared_ptr<SerialPort> getPort() const;
+
+    private:
+        /**
+         * A task waiting for the bus.
+         */
+        struct Waiter {
+            SerialPort::TimerType timer;
+            // Set when the bus is handed over to this task.
+            bool granted = false;
+
+            explicit Waiter(boost::asio::io_service &io) : timer(io) {
+            }
+        };
+
+        /**
+         * Owns the bus until destroyed, also when the task is unwound by an exception or destroyed itself.
+         */
+        class Lock {
+        public:
+            explicit Lock(AsyncBus *bus) : bus(bus) {
+            }
+
+            Lock(Lock &&other) noexcept : bus(std::exchange(other.bus, nullptr)) {
+            }
+
+            Lock(const Lock &) = delete;
+
+            Lock &operator=(const Lock &) = delete;
+
+            Lock &operator=(Lock &&) = delete;
+
+            ~Lock() {
+                if (bus) {
+                    bus->unlock();
+                }
+            }
+
+        private:
+            AsyncBus *bus;
+        };
+
+        std::shared_ptr<SerialPort> port;
+
+        bool busy = false;
+        std::deque<Waiter *> waiting;
+
+        /**
+         * Wait until the bus is free and take it.
+         * @return the lock of the bus.
+         */
+        boost::asio::awaitable<Lock> lock();
+
+        /**
+         * Hand the bus over to the next waiting task, or free it.
+         */
+        void unlock();
+
+        boost::asio::awaitable<size_t> read(boost::asio::mutable_buffer buffer, Transport::Clock::time_point deadline,
+                                            boost::system::error_code &error);
+
+        boost::asio::awaitable<boost::system::error_code> transactOnce(byte id,
+                                                                       const std::vector<byte> &instructionPacket,
+                                                                       std::vector<byte> &statusPacket);
+    };
+
+    /**
+     * Awaitable counterpart of `Dynamixel`, e.g. `int position = (co_await servo.presentPosition()).valueOr(0);`.
+     */
+    class AsyncDynamixel {
+    public:
+        using byte = Dynamixel::byte;
+        using Address = Dynamixel::Address;
+
+        /**
+         * @param id the unique ID of a Dynamixel unit. It must be in range (0, 0xFD).
+         * @param bus the bus where the Dynamixel unit is connected with.
+         */
+        AsyncDynamixel(byte id, std::shared_ptr<AsyncBus> bus);
+
+        /**
+         * Set the monitor that collects the error bits of this unit's status packets.
+         * @param monitor the error monitor.
+         */
+        void setErrorMonitor(std::shared_ptr<ErrorMonitor> monitor);
+
+        /**
+         * @return the error bits of the last status packet received from this unit.
+         */
+        byte getLastError() const;
+
+        int getId() const;
+
+        boost::asio::awaitable<Result<void>> ping();
+
+        boost::asio::awaitable<Result<std::vector<byte>>> readBlock(Address address, size_t length);
+
+        boost::asio::awaitable<Result<int>> readData(Address address, size_t length);
+
+        boost::asio::awaitable<Result<void>> writeData(Address address, std::vector<byte> data);
+
+        boost::asio::awaitable<Result<int>> goalPosition();
+
+        boost::asio::awaitable<Result<int>> movingSpeed();
+
+        boost::asio::awaitable<Result<int>> torqueLimit();
+
+        boost::asio::awaitable<Result<int>> presentPosition();
+
+        boost::asio::awaitable<Result<int>> presentSpeed();
+
+        /**
+         * @return the signed magnitude of the load, see `Dynamixel::getPresentLoad()`.
+         */
+        boost::asio::awaitable<Result<int>> presentLoad();
+
+        boost::asio::awaitable<Result<int>> presentVoltage();
+
+        boost::asio::awaitable<Result<int>> presentTemperature();
+
+        boost::asio::awaitable<Result<bool>> isMoving();
+
+        boost::asio::awaitable<Result<void>> setGoalPosition(short position);
+
+        boost::asio::awaitable<Result<void>> setMovingSpeed(short speed);
+
+        boost::asio::awaitable<Result<void>> moveTo(short position, short speed);
+
+    private:
+        byte id;
+        std::shared_ptr<AsyncBus> bus;
+
+        std::shared_ptr<ErrorMonitor> errorMonitor;
+        byte lastError = 0;
+
+        boost::asio::awaitable<Result<std::vector<byte>>> send(Dynamixel::Instruction instruction,
+                                                               std::vector<byte> data);
+    };
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Dynamixel.h"
+#include "SerialPort.h"
+
+namespace goliath::dynamixel {
+    /**
+     * Moves all Dynamixel units of a bus to another baud rate and return delay time in one coordinated operation.
+     * The baud rate is broadcast, so every unit on the bus switches at once. Every unit is then verified at the new
+     * baud rate; if any of them doesn't answer, the previous baud rate is broadcast at the new one before the serial
+     * port switches back, so units that took the new baud rate without answering don't stay behind.
+     */
+    class BusSpeedOptimizer {
+    public:
+        using byte = Dynamixel::byte;
+        using Clock = Transport::Clock;
+
+        struct ServoReport {
+            byte id;
+            // Whether the unit answered at the new baud rate.
+            bool verified = false;
+            // Mean ping round trip time.
+            Clock::duration roundTripBefore{};
+            Clock::duration roundTripAfter{};
+        };
+
+        struct Report {
+            // Whether all units run at the new settings.
+            bool success = false;
+            // Whether a failed migration has been undone; false if nothing had to be undone.
+            bool rolledBack = false;
+            unsigned int baudRateBefore = 0;
+            unsigned int baudRateAfter = 0;
+            std::vector<ServoReport> servos;
+            std::string error;
+        };
+
+        /**
+         * @param port the open serial port of the bus.
+         */
+        explicit BusSpeedOptimizer(std::shared_ptr<SerialPort> port);
+
+        /**
+         * Find the Dynamixel units that answer a ping at the current baud rate.
+         * @param firstId the first ID to ping.
+         * @param lastId the last ID to ping.
+         * @param timeout how long to wait for every ping.
+         * @return the units found, in order of their ID.
+         */
+        std::vector<std::shared_ptr<Dynamixel>> discover(byte firstId = 0, byte lastId = 0xFD,
+                                                         Clock::duration timeout = std::chrono::milliseconds(10));
+
+        /**
+         * Switch all units and the serial port to a new baud rate and return delay time.
+         * @param servos the units of the bus; all of them must be connected to the serial port and share the
+         * direction callback, if any.
+         * @param baudRate the new baud rate.
+         * @param returnDelayTime the new return delay time, in units of 2 uSec.
+         * @param pings the number of pings per unit to measure the round trip time.
+         * @return the report of the migration.
+         */
+        Report migrate(const std::vector<std::shared_ptr<Dynamixel>> &servos, unsigned int baudRate,
+                       int returnDelayTime, int pings = 10);
+
+    private:
+        std::shared_ptr<SerialPort> port;
+
+        /**
+         * @return the mean round trip time of successful pings, or zero if the unit didn't answer at all.
+         */
+        static Clock::duration measureRoundTrip(Dynamixel &servo, int pings);
+
+        /**
+         * Write the baud rate of all units with a broadcast packet, which isn't answered. The packet is sent with
+         * the direction callback of the first unit, so adapters whose direction is switched by it transmit it too.
+         * @param servos the units of the bus.
+         * @param baudRate the new baud rate of the units.
+         * @throws boost::system::system_error if any error.
+         */
+        void broadcastBaudRate(const std::vector<std::shared_ptr<Dynamixel>> &servos, unsigned int baudRate);
+
+        /**
+         * Undo a partial migration.
+         * @param switched whether the units were sent the new baud rate, i.e. the serial port runs at it.
+         * @return true if all units answer at the previous baud rate again; otherwise, false.
+         */
+        bool rollBack(const std::vector<std::shared_ptr<Dynamixel>> &servos, const std::vector<int> &returnDelays,
+                      bool switched, unsigned int baudRate, Report &report);
+    };
+}
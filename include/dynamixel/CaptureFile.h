@@ -0,0 +1,155 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace goliath::dynamixel {
+    /**
+     * A fixed-size record of a capture file.
+     * Packets longer than `PayloadSize` are split over consecutive records of the same sequence number.
+     */
+    struct CaptureRecord {
+        static constexpr size_t PayloadSize = 44;
+
+        enum class Direction : uint8_t {
+            Transmit = 0,
+            Receive = 1
+        };
+
+        enum Flags : uint8_t {
+            // More records of the same packet follow.
+            Continued = 1,
+            // The transfer failed (e.g. a read that timed out); the payload holds what was transferred.
+            Failed = 2
+        };
+
+        // Nanoseconds of the monotonic clock.
+        uint64_t timestamp;
+        // Sequence number of the packet this record belongs to: the index of its first record (modulo 2^32).
+        uint32_t sequence;
+        // Commit marker: the index of this record plus one (modulo 2^32) once it's completely written, 0 while
+        // it's written.
+        std::atomic<uint32_t> commit;
+        Direction direction;
+        uint8_t flags;
+        uint16_t length;
+        unsigned char payload[PayloadSize];
+    };
+
+    static_assert(sizeof(CaptureRecord) == 64, "capture records must stay 64 bytes");
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "capture files require lock-free 32 bit atomics");
+
+    /**
+     * The header of a capture file, followed by a ring of `capacity` records.
+     */
+    struct CaptureHeader {
+        static constexpr char Magic[8] = {'D', 'X', 'L', 'C', 'A', 'P', 0, 0};
+        static constexpr uint32_t CurrentVersion = 2;
+
+        char magic[8];
+        uint32_t version;
+        uint32_t recordSize;
+        uint64_t capacity;
+        // Number of records ever reserved; the ring holds the last `capacity` of them.
+        std::atomic<uint64_t> written;
+        // Number of packets ever recorded.
+        std::atomic<uint32_t> packets;
+        uint32_t reserved;
+        uint64_t padding[3];
+    };
+
+    static_assert(sizeof(CaptureHeader) == 64, "capture header must stay 64 bytes");
+
+    /**
+     * A packet reassembled from its capture records.
+     */
+    struct CapturedPacket {
+        std::chrono::steady_clock::time_point timestamp;
+        CaptureRecord::Direction direction;
+        bool failed;
+        std::vector<unsigned char> data;
+    };
+
+    /**
+     * Appends packets to a memory-mapped capture file.
+     */
+    class CaptureWriter {
+    public:
+        using byte = unsigned char;
+
+        /**
+         * Create (or truncate) a capture file.
+         * @param path the path of the capture file.
+         * @param capacity the number of records in the ring.
+         * @throws std::invalid_argument if the capacity is zero.
+         * @throws boost::system::system_error if the file can't be created or mapped.
+         */
+        CaptureWriter(const std::string &path, size_t capacity);
+
+        ~CaptureWriter();
+
+        CaptureWriter(const CaptureWriter &) = delete;
+
+        CaptureWriter &operator=(const CaptureWriter &) = delete;
+
+        /**
+         * Append a packet to the capture. Safe to call from multiple threads.
+         * @param direction whether the bytes were sent or received.
+         * @param data the bytes transferred.
+         * @param size the number of bytes transferred.
+         * @param failed whether the transfer failed.
+         */
+        void record(CaptureRecord::Direction direction, const byte *data, size_t size, bool failed = false);
+
+    private:
+        CaptureHeader *header;
+        CaptureRecord *records;
+        size_t mappedSize;
+    };
+
+    /**
+     * Reads a capture file through a read-only mapping.
+     */
+    class CaptureReader {
+    public:
+        /**
+         * Open a capture file.
+         * @param path the path of the capture file.
+         * @throws boost::system::system_error if the file can't be opened or mapped.
+         * @throws std::runtime_error if the file is no capture file of a supported version.
+         */
+        explicit CaptureReader(const std::string &path);
+
+        ~CaptureReader();
+
+        CaptureReader(const CaptureReader &) = delete;
+
+        CaptureReader &operator=(const CaptureReader &) = delete;
+
+        /**
+         * @return the number of records still held by the ring.
+         */
+        size_t size() const;
+
+        /**
+         * @param index the index of the record, 0 being the oldest record in the ring.
+         * @return the record. While the capture is written, it may be incomplete; check its commit marker.
+         */
+        const CaptureRecord &at(size_t index) const;
+
+        /**
+         * Reassemble the packets held by the ring, oldest first. A packet whose first records were overwritten, or
+         * that is still being written, is skipped.
+         * @return the packets.
+         */
+        std::vector<CapturedPacket> packets() const;
+
+    private:
+        const CaptureHeader *header;
+        const CaptureRecord *records;
+        size_t mappedSize;
+    };
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "CaptureFile.h"
+#include "Transport.h"
+#include <memory>
+
+namespace goliath::dynamixel {
+    /**
+     * Transport decorator that records every transmitted and received packet into a capture file.
+     */
+    class CaptureTransport final : public Transport {
+    public:
+        /**
+         * @param transport the transport that does the actual transfers.
+         * @param writer the capture the traffic is recorded into.
+         */
+        CaptureTransport(std::shared_ptr<Transport> transport, std::shared_ptr<CaptureWriter> writer);
+
+        using Transport::write;
+        using Transport::read;
+
+        size_t write(boost::asio::const_buffer data, boost::system::error_code &error) override;
+
+        size_t write(const std::vector<boost::asio::const_buffer> &buffers, boost::system::error_code &error) override;
+
+        size_t read(boost::asio::mutable_buffer buffer, Clock::time_point deadline,
+                    boost::system::error_code &error) override;
+
+        void flush(FlushType what) override;
+
+    private:
+        std::shared_ptr<Transport> transport;
+        std::shared_ptr<CaptureWriter> writer;
+    };
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "Dynamixel.h"
+#include "SharedMemory.h"
+#include <atomic>
+#include <cstdint>
+
+namespace goliath::dynamixel {
+    /**
+     * The header of a command ring region, followed by `capacity` command cells and `capacity` acknowledgements.
+     * The positions are on separate cache lines, so producers and the worker don't contend for them.
+     */
+    struct CommandRingHeader {
+        static constexpr char Magic[8] = {'D', 'X', 'L', 'C', 'M', 'D', 0, 0};
+        static constexpr uint32_t CurrentVersion = 1;
+
+        char magic[8];
+        uint32_t version;
+        uint32_t capacity;
+        uint64_t padding[6];
+
+        // The sequence number of the next command to be pushed.
+        alignas(64) std::atomic<uint64_t> enqueuePosition;
+        // The sequence number of the next command to be applied; all commands before it have been acknowledged.
+        alignas(64) std::atomic<uint64_t> dequeuePosition;
+        // The last tick in which commands were applied.
+        std::atomic<uint64_t> lastTick;
+    };
+
+    static_assert(sizeof(CommandRingHeader) == 192, "command ring header must stay 192 bytes");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "command rings require lock-free 64 bit atomics");
+
+    /**
+     * A command: write a 2 byte value to the control table of a unit.
+     */
+    struct CommandCell {
+        // `position` if the cell is free for the command of that sequence number, `position + 1` once it holds it.
+        std::atomic<uint64_t> sequence;
+        uint8_t id;
+        uint8_t address;
+        uint16_t value;
+        uint32_t reserved;
+    };
+
+    static_assert(sizeof(CommandCell) == 16, "command cells must stay 16 bytes");
+
+    /**
+     * The tick in which a command was applied.
+     */
+    struct CommandAck {
+        // The sequence number of the acknowledged command plus one; 0 if no command was acknowledged yet.
+        std::atomic<uint64_t> sequence;
+        uint64_t tick;
+    };
+
+    static_assert(sizeof(CommandAck) == 16, "command acknowledgements must stay 16 bytes");
+
+    /**
+     * The side of a command ring that owns the bus. Commands pushed by `CommandSender`s, possibly in other
+     * processes, are drained once per tick of the worker and merged into SYNC WRITE packets: one per control
+     * table address (or more, beyond `SyncWrite::getMaxUnits()` units), the last command per unit and address
+     * winning. Every drained command is acknowledged with
+     * the tick that applied it.
+     * A receiver is not thread safe; only the worker thread may apply commands.
+     */
+    class CommandReceiver {
+    public:
+        using byte = Dynamixel::byte;
+
+        // The acknowledged tick of commands that couldn't be sent.
+        static constexpr uint64_t FailedTick = UINT64_MAX;
+
+        /**
+         * Create the shared memory region; an existing region of the same name is replaced.
+         * @param name the name of the shared memory object, e.g. "/dynamixel-commands".
+         * @param capacity the number of commands the ring holds; a power of two.
+         * @throws std::invalid_argument if the capacity isn't a power of two.
+         * @throws boost::system::system_error if the region can't be created.
+         */
+        explicit CommandReceiver(const std::string &name, size_t capacity = 1024);
+
+        /**
+         * Drain the pending commands and send them. Commands claimed after the drain started are left for the next
+         * tick.
+         * @param port the transport the units are connected to.
+         * @param tick the number of the worker's tick, used to acknowledge the commands.
+         * @return the number of commands drained.
+         * @throws boost::system::system_error if a packet couldn't be sent; the drained commands are
+         * acknowledged with `FailedTick`.
+         */
+        size_t apply(Transport &port, uint64_t tick);
+
+    private:
+        struct Setpoint {
+            byte address;
+            byte id;
+            uint16_t value;
+        };
+
+        SharedMemory memory;
+        CommandRingHeader *header;
+        CommandCell *cells;
+        CommandAck *acks;
+
+        // Reused between ticks.
+        std::vector<Setpoint> setpoints;
+        // One plus the index in `setpoints` per (address, ID) pair, 0 for pairs that weren't commanded this tick.
+        std::vector<uint32_t> indices;
+
+        void acknowledge(uint64_t first, uint64_t last, uint64_t tick);
+    };
+
+    /**
+     * The producing side of a command ring, e.g. a planner in another process than the bus worker. Any number of
+     * senders, in any number of threads and processes, may push commands concurrently without locks.
+     * A sender that dies halfway a push blocks the ring.
+     */
+    class CommandSender {
+    public:
+        using byte = Dynamixel::byte;
+
+        /**
+         * Map an existing command ring.
+         * @param name the name of the shared memory object.
+         * @throws boost::system::system_error if the region doesn't exist or can't be mapped.
+         * @throws std::runtime_error if the region is no command ring of a supported version.
+         */
+        explicit CommandSender(const std::string &name);
+
+        /**
+         * Push a command.
+         * @param id the ID of the Dynamixel unit.
+         * @param address the address of a 2 byte value in the control table, e.g. `Address::GoalPosition`.
+         * @param value the value to be written.
+         * @param sequence receives the sequence number of the command.
+         * @return true if the command was pushed; false if the ring is full.
+         */
+        bool push(byte id, Dynamixel::Address address, uint16_t value, uint64_t &sequence);
+
+        /**
+         * @param sequence the sequence number of a command.
+         * @param tick receives the tick that applied the command, `CommandReceiver::FailedTick` if it couldn't
+         * be sent.
+         * @return true if the command was acknowledged and its acknowledgement is still held by the ring;
+         * otherwise, false.
+         */
+        bool isAcknowledged(uint64_t sequence, uint64_t &tick) const;
+
+        /**
+         * @return the number of commands acknowledged; all commands with a lower sequence number have been
+         * drained by the worker.
+         */
+        uint64_t getAcknowledged() const;
+
+        /**
+         * @return the last tick in which commands were applied.
+         */
+        uint64_t getLastTick() const;
+
+    private:
+        SharedMemory memory;
+        CommandRingHeader *header;
+        CommandCell *cells;
+        const CommandAck *acks;
+    };
+}
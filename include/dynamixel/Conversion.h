@@ -0,0 +1,120 @@
+#pragma once
+
+#include "State.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace goliath::dynamixel {
+    /**
+     * Batch conversions between raw control table values and SI units.
+     * The kernels work on plain arrays without branches, so the compiler can vectorize them. Signed quantities are
+     * counter clockwise positive, like the position.
+     * (see the official Dynamixel AX-12 User's manual p.16-18)
+     */
+    class Conversion {
+    public:
+        // 0 to 1023 spans 300 degrees.
+        static constexpr float RadiansPerTick = 300.0f / 1023.0f * 3.14159265358979f / 180.0f;
+        static constexpr uint16_t CenterPosition = 512;
+        static constexpr uint16_t MaxPosition = 1023;
+        // One speed unit is about 0.111 RPM, 1023 corresponds to 114 RPM.
+        static constexpr float RadiansPerSecondPerSpeedUnit = 0.111f * 2.0f * 3.14159265358979f / 60.0f;
+        // Position ticks per second covered at one speed unit.
+        static constexpr float TicksPerSecondPerSpeedUnit = RadiansPerSecondPerSpeedUnit / RadiansPerTick;
+        static constexpr uint16_t MaxSpeed = 1023;
+        // One load unit is about 0.1% of the maximum torque.
+        static constexpr float EffortPerLoadUnit = 1.0f / 1023.0f;
+        static constexpr uint16_t MaxTorque = 1023;
+        static constexpr float VoltsPerVoltageUnit = 0.1f;
+
+        /**
+         * @param raw *present position* values.
+         * @param offset joint angle in radians at the center position, per joint.
+         * @param direction 1 or -1 per joint.
+         * @param radians receives the joint angles.
+         * @param size the number of joints.
+         */
+        static void positionToRadians(const uint16_t *raw, const float *offset, const float *direction,
+                                      float *radians, size_t size);
+
+        /**
+         * @param radians the joint angles.
+         * @param offset joint angle in radians at the center position, per joint.
+         * @param direction 1 or -1 per joint.
+         * @param raw receives *goal position* values, clamped to range (0, 1023).
+         * @param size the number of joints.
+         */
+        static void radiansToPosition(const float *radians, const float *offset, const float *direction,
+                                      uint16_t *raw, size_t size);
+
+        /**
+         * @param raw *present speed* values.
+         * @param direction 1 or -1 per joint.
+         * @param velocity receives the angular velocities in radians per second.
+         * @param size the number of joints.
+         */
+        static void speedToRadiansPerSecond(const uint16_t *raw, const float *direction, float *velocity,
+                                            size_t size);
+
+        /**
+         * The sign is dropped, as the *moving speed* of a joint is a magnitude. The result is at least 1, because
+         * zero means "no velocity control".
+         * @param velocity the angular velocities in radians per second.
+         * @param raw receives *moving speed* values, clamped to range (1, 1023).
+         * @param size the number of joints.
+         */
+        static void radiansPerSecondToSpeed(const float *velocity, uint16_t *raw, size_t size);
+
+        /**
+         * @param raw *present load* values.
+         * @param direction 1 or -1 per joint.
+         * @param effort receives the load as a fraction of the maximum torque.
+         * @param size the number of joints.
+         */
+        static void loadToEffort(const uint16_t *raw, const float *direction, float *effort, size_t size);
+
+        /**
+         * @param effort the torque limits as a fraction of the maximum torque.
+         * @param raw receives *torque limit* values, clamped to range (0, 1023).
+         * @param size the number of joints.
+         */
+        static void effortToTorqueLimit(const float *effort, uint16_t *raw, size_t size);
+
+        /**
+         * @param raw *present voltage* values.
+         * @param volts receives the voltages in Volts.
+         * @param size the number of units.
+         */
+        static void voltageToVolts(const uint8_t *raw, float *volts, size_t size);
+
+        /**
+         * @param volts the voltages in Volts.
+         * @param raw receives voltage values, e.g. for the voltage limits.
+         * @param size the number of units.
+         */
+        static void voltsToVoltage(const float *volts, uint8_t *raw, size_t size);
+
+        /**
+         * @param raw *present temperature* values.
+         * @param celsius receives the temperatures in degrees Celsius.
+         * @param size the number of units.
+         */
+        static void temperatureToCelsius(const uint8_t *raw, float *celsius, size_t size);
+
+        /**
+         * @param celsius the temperatures in degrees Celsius.
+         * @param raw receives temperature values, e.g. for the temperature limit.
+         * @param size the number of units.
+         */
+        static void celsiusToTemperature(const float *celsius, uint8_t *raw, size_t size);
+
+        /**
+         * Convert a complete raw state to joint space.
+         * @param raw the raw state.
+         * @param calibration the calibration of the joints, of the same size as the raw state.
+         * @param joints receives the joint state; it's resized to the raw state.
+         * @throws std::invalid_argument if the calibration doesn't have the size of the raw state.
+         */
+        static void toJointState(const RawState &raw, const Calibration &calibration, JointState &joints);
+    };
+}
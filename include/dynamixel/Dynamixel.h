@@ -1,10 +1,17 @@
 #pragma once
 
-#include "SerialPort.h"
+#include "ErrorMonitor.h"
+#include "Result.h"
+#include "Transport.h"
 #include "Utils.h"
 #include <boost/format.hpp>
+#include <functional>
+#include <future>
+#include <memory>
 
 namespace goliath::dynamixel {
+    class WriteBatcher;
+
     class Dynamixel {
     public:
         using byte = unsigned char;
@@ -18,7 +25,7 @@ namespace goliath::dynamixel {
             RegWrite = 4,
             Action = 5,
             Reset = 6,
-            SyncWrite = 83
+            SyncWrite = 0x83
         };
 
         // Control table (addresses).
@@ -86,12 +93,42 @@ namespace goliath::dynamixel {
             Instruction = 64,
         };
 
+        /**
+         * Instruction packets sent to this ID are executed by all Dynamixel units, which don't return a status
+         * packet.
+         */
+        static constexpr byte BroadcastId = 0xFE;
+
+        /**
+         * The length byte of a packet counts the parameters plus 2, which limits their number.
+         */
+        static constexpr size_t MaxParameters = 0xFF - 2;
+
+        /**
+         * Monotonic timestamps of a transaction.
+         */
+        struct Timing {
+            // When writing the instruction packet started.
+            Transport::Clock::time_point transmitted;
+            // When the last byte of the status packet was received.
+            Transport::Clock::time_point received;
+
+            /**
+             * The unit samples its state between receiving the instruction packet and sending the status packet;
+             * without knowing the baud rate and return delay time, halfway the round trip is the best estimate.
+             * @return the estimated time the status packet's values were sampled.
+             */
+            Transport::Clock::time_point sampled() const {
+                return transmitted + (received - transmitted) / 2;
+            }
+        };
+
         /**
          * Construct a Dynamixel actuator class.
          * @param id the unique ID of a Dynamixel unit. It must be in range (0, 0xFD).
-         * @param port the serial port where the Dynamixel unit is connected with.
+         * @param port the transport (e.g. a serial port) where the Dynamixel unit is connected with.
          */
-        Dynamixel(byte id, std::shared_ptr<SerialPort> port);
+        Dynamixel(byte id, std::shared_ptr<Transport> port);
 
         /* Low level functions */
 
@@ -102,15 +139,95 @@ namespace goliath::dynamixel {
          */
         void setDirectionCallback(std::function<void(bool)> callback);
 
+        /**
+         * @return the direction callback, empty if none is set.
+         */
+        const std::function<void(bool)> &getDirectionCallback() const;
+
+        /**
+         * Set the monitor that collects the error bits of this unit's status packets.
+         * By default all units report to `ErrorMonitor::getDefault()`.
+         * @param monitor the error monitor.
+         */
+        void setErrorMonitor(std::shared_ptr<ErrorMonitor> monitor);
+
+        /**
+         * @return the error monitor this unit reports to.
+         */
+        std::shared_ptr<ErrorMonitor> getErrorMonitor() const;
+
+        /**
+         * Queue the writes of `queueWriteData()`, `queueSetGoalPosition()`, `queueSetMovingSpeed()` and
+         * `queueMoveTo()` in a batcher, which sends them together with the writes to other units as SYNC WRITEs;
+         * all other writes, including those of `setGoalPosition()` and friends, are still sent right away. Errors of
+         * batched writes are only reported through their futures. The batcher sends through its own transport, so
+         * batched writes skip the direction callback of this unit.
+         * @param batcher the batcher, or nullptr to send every write right away.
+         */
+        void setWriteBatcher(std::shared_ptr<WriteBatcher> batcher);
+
+        /**
+         * @return the batcher writes are queued in, if any.
+         */
+        std::shared_ptr<WriteBatcher> getWriteBatcher() const;
+
+        /**
+         * The error bits of the last status packet received from this unit, i.e. a combination of `Error` values.
+         * @return the error bits, or zero if the last status packet reported no error.
+         */
+        byte getLastError() const;
+
+        /**
+         * @return the timestamps of the last successful transaction with this unit, i.e. of the values returned
+         * last.
+         */
+        Timing getLastTiming() const;
+
+        /**
+         * @param error the error to check for.
+         * @return true if the last status packet of this unit had the error bit set; otherwise, false.
+         */
+        bool hasError(Error error) const;
+
         /**
          * Send an instruction packet and receive the status packet.
          * @param instruction the instruction for the Dynamixel actuator to perform.
          * @param data a vector of bytes containing the packet's data: the
          * instruction to perform or the status of the Dynamixel actuator.
          * @return a vector of bytes containing the status packet's data.
+         * @throws boost::system::system_error if no valid status packet was received.
          */
         std::vector<byte> send(Instruction instruction, const std::vector<byte> &data, int tries = 5);
 
+        /**
+         * Send an instruction packet and receive the status packet without throwing on bus errors.
+         * @param instruction the instruction for the Dynamixel actuator to perform.
+         * @param data a vector of bytes containing the packet's parameters.
+         * @param tries how many times the transaction is retried after an error.
+         * @return the status packet (without checksum), or the error of the last try. Transport errors, including
+         * those of flushing it, are returned rather than thrown; a failed transfer carries no servo error bits.
+         */
+        Result<std::vector<byte>> trySend(Instruction instruction, const std::vector<byte> &data, int tries = 5);
+
+        /**
+         * Send an already encoded instruction packet addressed to this unit, e.g. a `PreparedCommand`, and receive
+         * the status packet without throwing on bus errors.
+         * @param instructionPacket the instruction packet.
+         * @param tries how many times the transaction is retried after an error.
+         * @return the status packet (without checksum), or the error of the last try. Transport errors, including
+         * those of flushing it, are returned rather than thrown; a failed transfer carries no servo error bits.
+         */
+        Result<std::vector<byte>> trySendPacket(const std::vector<byte> &instructionPacket, int tries = 5);
+
+        /**
+         * Send an instruction packet without waiting for a status packet, for instructions the unit doesn't
+         * answer, e.g. a write that turns its status packets off.
+         * @param instruction the instruction for the Dynamixel actuator to perform.
+         * @param data a vector of bytes containing the packet's parameters.
+         * @return the transport error, if any; there are no servo error bits.
+         */
+        Result<void> trySendWithoutReply(Instruction instruction, const std::vector<byte> &data);
+
         /**
          * The "instruction packet" is the packet sent to the Dynamixel units.
          * @param instruction the instruction for the Dynamixel actuator to perform.
@@ -120,6 +237,50 @@ namespace goliath::dynamixel {
          */
         std::vector<byte> getInstructionPacket(Instruction instruction, const std::vector<byte> &data);
 
+        /**
+         * Build an instruction packet for an arbitrary Dynamixel unit.
+         * @param id the ID of the addressed Dynamixel unit, or `BroadcastId`.
+         * @param instruction the instruction for the Dynamixel actuator to perform.
+         * @param data a vector of bytes containing the packet's data.
+         * @return a vector of bytes containing the instruction packet's data.
+         * @throws std::invalid_argument if there are more than `MaxParameters` parameters.
+         */
+        static std::vector<byte> getInstructionPacket(byte id, Instruction instruction, const std::vector<byte> &data);
+
+        /**
+         * Check the first 5 bytes of a status packet.
+         * @param statusPacket the status packet received so far.
+         * @param id the ID of the Dynamixel unit that should have sent it.
+         * @param length receives the number of bytes that follow, i.e. the parameters and the checksum.
+         * @return the error, if the header is invalid.
+         */
+        static boost::system::error_code checkStatusHeader(const std::vector<byte> &statusPacket, byte id,
+                                                           size_t &length);
+
+        /**
+         * Check the first 5 bytes of a status packet in a caller-owned buffer.
+         * @param statusPacket the status packet received so far, at least 5 bytes.
+         * @param id the ID of the Dynamixel unit that should have sent it.
+         * @param length receives the number of bytes that follow, i.e. the parameters and the checksum.
+         * @return the error, if the header is invalid.
+         */
+        static boost::system::error_code checkStatusHeader(const byte *statusPacket, byte id, size_t &length);
+
+        /**
+         * Verify the checksum of a complete status packet and remove it.
+         * @param statusPacket the complete status packet.
+         * @return the error, if the checksum doesn't match.
+         */
+        static boost::system::error_code checkStatusChecksum(std::vector<byte> &statusPacket);
+
+        /**
+         * Verify the checksum of a complete status packet in a caller-owned buffer.
+         * @param statusPacket the complete status packet.
+         * @param size the size of the status packet, including the checksum.
+         * @return the error, if the checksum doesn't match.
+         */
+        static boost::system::error_code checkStatusChecksum(const byte *statusPacket, size_t size);
+
         /* High level functions */
 
         /**
@@ -131,6 +292,25 @@ namespace goliath::dynamixel {
          */
         int readData(Address address, size_t length);
 
+        /**
+         * Read a block of the control table of the specified Dynamixel unit.
+         * @param address the starting address of the location where the data
+         * is to be read.
+         * @param length the number of bytes to be read.
+         * @param tries how many times the read is retried after an error.
+         * @return the bytes that have been read, or the error.
+         */
+        Result<std::vector<byte>> tryReadBlock(Address address, size_t length, int tries = 5);
+
+        /**
+         * Read data from the control table of the specified Dynamixel unit.
+         * @param address the starting address of the location where the data
+         * is to be read.
+         * @param length the length of the data to be read, 1 or 2 bytes.
+         * @return the data that has been read, or the error.
+         */
+        Result<int> tryReadData(Address address, size_t length);
+
         /**
          * Write bytes to the control table of the specified Dynamixel unit.
          * @param address the starting address of the location where the data
@@ -139,12 +319,38 @@ namespace goliath::dynamixel {
          */
         void writeData(Address address, const std::vector<byte> &data);
 
+        /**
+         * Write bytes to the control table of the specified Dynamixel unit.
+         * @param address the starting address of the location where the data
+         * is to be written.
+         * @param data the bytes of the data to be written.
+         * @return the outcome of the write.
+         */
+        Result<void> tryWriteData(Address address, const std::vector<byte> &data);
+
+        /**
+         * Write bytes to the control table of the specified Dynamixel unit through the write batcher, or right
+         * away if none is set.
+         * @param address the starting address of the location where the data
+         * is to be written.
+         * @param data the bytes of the data to be written.
+         * @return a future that becomes ready once the data is sent, holding the error if it couldn't be.
+         */
+        std::future<void> queueWriteData(Address address, const std::vector<byte> &data);
+
         /**
          * Ping the specified Dynamixel unit.
          * @return true if the specified unit is available; otherwise, false.
          */
         bool ping();
 
+        /**
+         * Ping the specified Dynamixel unit without throwing if it doesn't answer.
+         * @param tries how many times the ping is retried after an error.
+         * @return success if the specified unit is available; otherwise, the error.
+         */
+        Result<void> tryPing(int tries = 5);
+
         /* High level accessors */
 
         /**
@@ -152,12 +358,22 @@ namespace goliath::dynamixel {
          */
         int getFirmwareVersion();
 
+        /**
+         * @return the firmware version of the specified Dynamixel unit, or the error.
+         */
+        Result<int> tryGetFirmwareVersion();
+
         /**
          * @return the communication speed (baud rate) of the specified
          * Dynamixel unit.
          */
         unsigned int getBaudRate();
 
+        /**
+         * @return the communication speed (baud rate) of the specified Dynamixel unit, or the error.
+         */
+        Result<unsigned int> tryGetBaudRate();
+
         /**
          * The return delay time is the time it takes (in uSec) for the status
          * packet to return after the instruction packet is sent.
@@ -165,6 +381,11 @@ namespace goliath::dynamixel {
          */
         int getReturnDelayTime();
 
+        /**
+         * @return the return delay time of the specified Dynamixel unit, or the error.
+         */
+        Result<int> tryGetReturnDelayTime();
+
         /**
          * The goal position should be higher or equal than this value, otherwise
          * the *Angle Limit Error Bit* (the second error bit of status packets)
@@ -173,6 +394,11 @@ namespace goliath::dynamixel {
          */
         int getCWAngleLimit();
 
+        /**
+         * @return the *clockwise angle limit* of the specified Dynamixel unit, or the error.
+         */
+        Result<int> tryGetCWAngleLimit();
+
         /**
          * The goal position should be lower or equal than this value, otherwise
          * the *Angle Limit Error Bit* (the second error bit of status packets)
@@ -182,6 +408,11 @@ namespace goliath::dynamixel {
          */
         int getCCWAngleLimit();
 
+        /**
+         * @return the *counter clockwise angle limit* of the specified Dynamixel unit, or the error.
+         */
+        Result<int> tryGetCCWAngleLimit();
+
         /**
          * If the internal temperature of the Dynamixel actuator gets higher than
          * this value, the *Over Heating Error Bit* (the third error bit of
@@ -192,6 +423,11 @@ namespace goliath::dynamixel {
          */
         int getMaxTemperature();
 
+        /**
+         * @return the maximum tolerated internal temperature of the specified Dynamixel unit, or the error.
+         */
+        Result<int> tryGetMaxTemperature();
+
         /**
          * If the present voltage of the Dynamixel actuator gets lower than
          * this value, the *Voltage Range Error Bit* (the first error bit of
@@ -202,6 +438,11 @@ namespace goliath::dynamixel {
          */
         int getMinVoltage();
 
+        /**
+         * @return the minimum tolerated operating voltage of the specified Dynamixel unit, or the error.
+         */
+        Result<int> tryGetMinVoltage();
+
         /**
          * If the present voltage of the Dynamixel actuator gets higher than
          * this value, the *Voltage Range Error Bit* (the first error bit of
@@ -212,6 +453,11 @@ namespace goliath::dynamixel {
          */
         int getMaxVoltage();
 
+        /**
+         * @return the maximum tolerated operating voltage of the specified Dynamixel unit, or the error.
+         */
+        Result<int> tryGetMaxVoltage();
+
         /**
          * This value, written in EEPROM, is copied to the *torque limit* bytes
          * (in RAM) when the power is turned ON. Thus, *max torque* is just an
@@ -224,6 +470,11 @@ namespace goliath::dynamixel {
          */
         int getMaxTorque();
 
+        /**
+         * @return the initial maximum torque output of the specified Dynamixel unit, or the error.
+         */
+        Result<int> tryGetMaxTorque();
+
         /**
          * +----------------+----------------------------------------+
          * | Returned value | Meaning                                |
@@ -239,6 +490,11 @@ namespace goliath::dynamixel {
          */
         int getStatusReturnLevel();
 
+        /**
+         * @return the status return level of the specified Dynamixel unit, or the error.
+         */
+        Result<int> tryGetStatusReturnLevel();
+
         /**
          * The calibration value is used to compensate the differences between the
          * potentiometers used in the Dynamixel units.
@@ -246,6 +502,11 @@ namespace goliath::dynamixel {
          */
         int getDownCalibration();
 
+        /**
+         * @return the "down calibration" value of the specified Dynamixel unit, or the error.
+         */
+        Result<int> tryGetDownCalibration();
+
         /**
          * The calibration value is used to compensate the differences between the
          * potentiometers used in the Dynamixel units.
@@ -253,6 +514,11 @@ namespace goliath::dynamixel {
          */
         int getUpCalibration();
 
+        /**
+         * @return the "up calibration" value of the specified Dynamixel unit, or the error.
+         */
+        Result<int> tryGetUpCalibration();
+
         /**
          * @return true if the torque of the specified Dynamixel unit is
          * enabled; otherwise, false.
@@ -303,6 +569,11 @@ namespace goliath::dynamixel {
          */
         int getGoalPosition();
 
+        /**
+         * @return the requested goal angular position, or the error.
+         */
+        Result<int> tryGetGoalPosition();
+
         /**
          * This angular velocity is defined in range (0, 1023) i.e. (0, 0x3FF) in
          * hexadecimal notation. The maximum value (1023 or 0x3FF) corresponds to
@@ -314,25 +585,45 @@ namespace goliath::dynamixel {
          */
         int getMovingSpeed();
 
+        /**
+         * @return the angular velocity of the specified Dynamixel unit, or the error.
+         */
+        Result<int> tryGetMovingSpeed();
+
         /**
          * @return the maximum torque output of the specified Dynamixel unit.
          */
         int getTorqueLimit();
 
+        /**
+         * @return the maximum torque output of the specified Dynamixel unit, or the error.
+         */
+        Result<int> tryGetTorqueLimit();
+
         /**
          * @return the current angular position defined in range (0, 1023)
          * of the specified Dynamixel unit.
          */
         int getPresentPosition();
 
+        /**
+         * @return the current angular position of the specified Dynamixel unit, or the error.
+         */
+        Result<int> tryGetPresentPosition();
+
         /**
          * @return the current angular velocity of the specified Dynamixel unit.
          */
         int getPresentSpeed();
 
+        /**
+         * @return the current angular velocity of the specified Dynamixel unit, or the error.
+         */
+        Result<int> tryGetPresentSpeed();
+
         /**
          * If the returned value is negative, the load is applied to the clockwise
-         * direction.
+         * direction (i.e. bit 10 of the *present load* is set), like in `Conversion::loadToEffort()`.
          * If the returned value is positive, the load is applied to the counter
          * clockwise direction.
          * @return the magnitude of the load applied to the specified Dynamixel
@@ -340,24 +631,45 @@ namespace goliath::dynamixel {
          */
         int getPresentLoad();
 
+        /**
+         * Unlike `getPresentLoad()`, a failed read can't be mistaken for a load.
+         * @return the signed magnitude of the load applied to the specified Dynamixel unit, or the error.
+         */
+        Result<int> tryGetPresentLoad();
+
         /**
          * @return the voltage currently applied to the specified Dynamixel
          * unit (in Volts).
          */
         int getPresentVoltage();
 
+        /**
+         * @return the voltage currently applied to the specified Dynamixel unit, or the error.
+         */
+        Result<int> tryGetPresentVoltage();
+
         /**
          * @return the internal temperature of the specified Dynamixel unit (in
          * Degrees Celsius).
          */
         int getPresentTemperature();
 
+        /**
+         * @return the internal temperature of the specified Dynamixel unit, or the error.
+         */
+        Result<int> tryGetPresentTemperature();
+
         /**
          * @return true if the specified Dynamixel unit is moving by its own
          * power; otherwise, false.
          */
         bool isMoving();
 
+        /**
+         * @return whether the specified Dynamixel unit is moving by its own power, or the error.
+         */
+        Result<bool> tryIsMoving();
+
         /**
          * @return true if the specified Dynamixel unit is locked; otherwise,
          * false.
@@ -397,6 +709,14 @@ namespace goliath::dynamixel {
          */
         void setBaudRate(unsigned int baudRate);
 
+        /**
+         * Set the *baud rate* for the specified Dynamixel unit.
+         * @param baudRate the new baud rate assigned to the selected
+         * Dynamixel unit.
+         * @return the outcome of the write.
+         */
+        Result<void> trySetBaudRate(unsigned int baudRate);
+
         /**
          * Set the *return delay time* for the specified Dynamixel unit.
          * i.e. the time for the status packets to return after the instruction
@@ -406,6 +726,14 @@ namespace goliath::dynamixel {
          */
         void setReturnDelayTime(int returnDelayTime);
 
+        /**
+         * Set the *return delay time* for the specified Dynamixel unit.
+         * @param returnDelayTime the new return delay time. It must be in
+         * range (0, 255).
+         * @return the outcome of the write.
+         */
+        Result<void> trySetReturnDelayTime(int returnDelayTime);
+
         /**
          * Set the *clockwise angle limit* of the specified Dynamixel unit to
          * the specified `angleLimit`.
@@ -434,12 +762,42 @@ namespace goliath::dynamixel {
          */
         void setMovingSpeed(short speed);
 
+        /**
+         * Set the *moving speed* for the specified Dynamixel unit.
+         * @param speed the new moving speed. It must be in range (0, 1023).
+         * @return the outcome of the write.
+         */
+        Result<void> trySetMovingSpeed(short speed);
+
+        /**
+         * Set the *moving speed* for the specified Dynamixel unit through the write batcher, or right away if none
+         * is set.
+         * @param speed the new moving speed. It must be in range (0, 1023).
+         * @return a future that becomes ready once the data is sent, holding the error if it couldn't be.
+         */
+        std::future<void> queueSetMovingSpeed(short speed);
+
         /**
          * Set the *goal position* for the specified Dynamixel unit.
          * @param speed the new goal position. It must be in range (0, 1023).
          */
         void setGoalPosition(short position);
 
+        /**
+         * Set the *goal position* for the specified Dynamixel unit.
+         * @param position the new goal position. It must be in range (0, 1023).
+         * @return the outcome of the write.
+         */
+        Result<void> trySetGoalPosition(short position);
+
+        /**
+         * Set the *goal position* for the specified Dynamixel unit through the write batcher, or right away if none
+         * is set.
+         * @param position the new goal position. It must be in range (0, 1023).
+         * @return a future that becomes ready once the data is sent, holding the error if it couldn't be.
+         */
+        std::future<void> queueSetGoalPosition(short position);
+
         /**
          * Set the *goal position* and *moving speed* for the specified
          * Dynamixel unit.
@@ -448,6 +806,24 @@ namespace goliath::dynamixel {
          */
         void moveTo(short position, short speed);
 
+        /**
+         * Set the *goal position* and *moving speed* for the specified
+         * Dynamixel unit.
+         * @param position the new goal position. It must be in range (0, 1023).
+         * @param speed the new moving speed. It must be in range (0, 1023).
+         * @return the outcome of the write.
+         */
+        Result<void> tryMoveTo(short position, short speed);
+
+        /**
+         * Set the *goal position* and *moving speed* for the specified
+         * Dynamixel unit through the write batcher, or right away if none is set.
+         * @param position the new goal position. It must be in range (0, 1023).
+         * @param speed the new moving speed. It must be in range (0, 1023).
+         * @return a future that becomes ready once the data is sent, holding the error if it couldn't be.
+         */
+        std::future<void> queueMoveTo(short position, short speed);
+
         /**
          * Reset the control table to the factory default setting.
          */
@@ -457,16 +833,44 @@ namespace goliath::dynamixel {
         const std::size_t readDelay = 100;
 
         byte id;
-        std::shared_ptr<SerialPort> port;
+        std::shared_ptr<Transport> port;
 
         std::function<void(bool)> callback;
 
+        std::shared_ptr<ErrorMonitor> errorMonitor;
+        std::shared_ptr<WriteBatcher> writeBatcher;
+        byte lastError = 0;
+        Timing lastTiming;
+
         /**
-         * Check error bit flags. And log them if there's any error.
+         * Check error bit flags and report them to the error monitor.
          * @param errorCode error bit flags.
          */
         void checkError(byte errorCode);
 
+        /**
+         * Flush the receive queue and send an instruction packet, switching the direction around it.
+         * @param instructionPacket the encoded instruction packet.
+         * @param transmitStart set to the time the packet started to be written.
+         * @return the transport error, if any.
+         */
+        boost::system::error_code writePacket(const std::vector<byte> &instructionPacket,
+                                              Transport::Clock::time_point &transmitStart);
+
+        /**
+         * Perform a single transaction: send the instruction packet and receive the status packet.
+         * @param instructionPacket the encoded instruction packet.
+         * @param statusPacket filled with the status packet (without checksum).
+         * @return the error of the transaction, if any.
+         */
+        boost::system::error_code transact(const std::vector<byte> &instructionPacket,
+                                           std::vector<byte> &statusPacket);
+
+        /**
+         * @return the *goal position* followed by the *moving speed*, as written by a move.
+         */
+        static std::vector<byte> getMoveData(short position, short speed);
+
         /**
          * Removes all irrelevant data from the status packet.
          * @param statusPacket a vector of bytes containing the status packet's data.
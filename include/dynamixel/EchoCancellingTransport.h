@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Transport.h"
+#include <memory>
+
+namespace goliath::dynamixel {
+    /**
+     * Transport decorator for single-wire half-duplex adapters that loop the transmitted bytes back into RX.
+     * After every write the echo is read and compared with what was sent, so the following read starts at the
+     * status packet. If the echo differs (or doesn't arrive in time), another device was driving the line and the
+     * write fails with `Errc::BusContention`, which `Dynamixel` retries like any other bus error.
+     * Such adapters switch direction by themselves, so no direction callback is needed.
+     */
+    class EchoCancellingTransport final : public Transport {
+    public:
+        /**
+         * @param transport the transport that does the actual transfers. The echo is awaited as long as a reply,
+         * see `setTimeout()`.
+         */
+        explicit EchoCancellingTransport(std::shared_ptr<Transport> transport);
+
+        using Transport::write;
+        using Transport::read;
+
+        size_t write(boost::asio::const_buffer data, boost::system::error_code &error) override;
+
+        size_t write(const std::vector<boost::asio::const_buffer> &buffers, boost::system::error_code &error) override;
+
+        size_t read(boost::asio::mutable_buffer buffer, Clock::time_point deadline,
+                    boost::system::error_code &error) override;
+
+        void flush(FlushType what) override;
+
+        /**
+         * @return the number of writes whose echo didn't match.
+         */
+        uint64_t getContentions() const;
+
+    private:
+        std::shared_ptr<Transport> transport;
+        uint64_t contentions = 0;
+
+        // Reused between writes.
+        std::vector<byte> echo;
+
+        /**
+         * Read the echo of a write and compare it with the transmitted buffers.
+         * @param buffers the transmitted buffers, taken as an array so a single buffer needs no vector.
+         * @param count the number of buffers.
+         * @param size the number of bytes written.
+         * @param error set to `Errc::BusContention` if the echo doesn't match.
+         */
+        void cancelEcho(const boost::asio::const_buffer *buffers, size_t count, size_t size,
+                        boost::system::error_code &error);
+    };
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Dynamixel.h"
+#include <array>
+
+namespace goliath::dynamixel {
+    /**
+     * The EEPROM area of the control tables (address 0 to 23) of several Dynamixel units, read with one READ
+     * instruction per unit. A snapshot can be saved to and loaded from a compact file, compared with another
+     * snapshot, and restored by writing only the bytes that differ.
+     * Only the writable configuration (return delay time up to alarm shutdown, except the reserved address 10) is
+     * restored: the ID identifies the units and the baud rate is migrated with `BusSpeedOptimizer`.
+     * (see the official Dynamixel AX-12 User's manual p.12)
+     */
+    class EepromSnapshot {
+    public:
+        using byte = Dynamixel::byte;
+
+        static constexpr size_t EepromSize = 24;
+
+        struct Entry {
+            byte id;
+            std::array<byte, EepromSize> data;
+        };
+
+        /**
+         * A range of bytes to write to a unit with a single WRITE instruction.
+         */
+        struct Change {
+            byte id;
+            Dynamixel::Address address;
+            std::vector<byte> data;
+        };
+
+        /**
+         * Read the EEPROM area of units; the entries of units that are read replace previous entries of the same
+         * ID.
+         * @param servos the Dynamixel units to read.
+         * @param tries how many times a read is retried after an error.
+         * @return the number of units that were read successfully.
+         */
+        size_t read(const std::vector<std::shared_ptr<Dynamixel>> &servos, int tries = 1);
+
+        /**
+         * Save the snapshot to a file.
+         * @param path the path of the file.
+         * @throws std::runtime_error if the file can't be written.
+         */
+        void save(const std::string &path) const;
+
+        /**
+         * Replace the snapshot by the contents of a file.
+         * @param path the path of the file.
+         * @throws std::runtime_error if the file can't be read or is no snapshot of a supported version.
+         */
+        void load(const std::string &path);
+
+        /**
+         * @return the entries, in the order the units were read.
+         */
+        const std::vector<Entry> &getEntries() const;
+
+        /**
+         * @param id the ID of a Dynamixel unit.
+         * @return the entry of the unit, or nullptr if the snapshot doesn't hold the unit.
+         */
+        const Entry *find(byte id) const;
+
+        /**
+         * Compute the writes that turn this snapshot into the desired one. Changed bytes are coalesced into as few
+         * writes as possible: ranges are joined over unchanged bytes (which are rewritten with their present
+         * value) as long as the gap is writable and at most `maxGap` bytes long. The status return level is never
+         * joined, but written on its own after the other writes of its unit. Units that aren't in both snapshots
+         * are left out.
+         * Rewriting unchanged bytes wears the EEPROM, so by default only changed bytes are written.
+         * @param desired the desired configuration.
+         * @param maxGap the longest gap of unchanged bytes to join ranges over; 0 writes changed bytes only.
+         * @return the writes, at most a few per unit.
+         */
+        std::vector<Change> diff(const EepromSnapshot &desired, size_t maxGap = 0) const;
+
+        /**
+         * Restore the configuration of this snapshot: read the present EEPROM area of the units, and write only the
+         * ranges that differ. The status return level is written last and without waiting for a status packet, as
+         * the unit may no longer send one.
+         * @param servos the Dynamixel units to restore; units not in this snapshot are skipped.
+         * @param maxGap the longest gap of unchanged bytes to join ranges over, see `diff()`.
+         * @param tries how many times a transaction is retried after an error.
+         * @return the writes performed.
+         * @throws boost::system::system_error if a unit couldn't be read or written; the writes before are kept.
+         */
+        std::vector<Change> restore(const std::vector<std::shared_ptr<Dynamixel>> &servos,
+                                    size_t maxGap = 0, int tries = 1) const;
+
+        /**
+         * @param address an address of the control table.
+         * @return true if the address is restored by `restore()`; otherwise, false.
+         */
+        static bool isRestorable(size_t address);
+
+    private:
+        std::vector<Entry> entries;
+
+        void set(const Entry &entry);
+
+        static void diff(const Entry &present, const Entry &desired, size_t maxGap, std::vector<Change> &changes);
+    };
+}
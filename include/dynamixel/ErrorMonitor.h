@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace goliath::dynamixel {
+    /**
+     * Collects the error bits of status packets per Dynamixel unit.
+     * Recording only updates counters and a bounded event ring; log lines are rate limited per unit, so a unit that
+     * keeps reporting the same error doesn't flood the log.
+     */
+    class ErrorMonitor {
+    public:
+        using byte = unsigned char;
+        using Clock = std::chrono::steady_clock;
+
+        static constexpr size_t ErrorBits = 7;
+        static constexpr size_t MaxId = 0xFD;
+
+        /**
+         * A change of the error bits reported by a Dynamixel unit.
+         */
+        struct Event {
+            byte id;
+            byte flags;
+            Clock::time_point time;
+        };
+
+        /**
+         * Error statistics of a Dynamixel unit. The arrays are indexed by error bit, i.e. the bit number of the
+         * corresponding `Dynamixel::Error`.
+         */
+        struct Statistics {
+            std::array<uint32_t, ErrorBits> counts{};
+            std::array<Clock::time_point, ErrorBits> lastSeen{};
+            // Number of status packets with any error bit set.
+            uint64_t packets = 0;
+            // The error bits of the last status packet.
+            byte flags = 0;
+        };
+
+        /**
+         * @param eventCapacity the number of events kept in the event ring.
+         * @param logInterval the minimum time between two log lines for the same unchanged error of a unit.
+         */
+        explicit ErrorMonitor(size_t eventCapacity = 64,
+                              Clock::duration logInterval = std::chrono::seconds(1));
+
+        /**
+         * @return the monitor that Dynamixel instances report to unless another one is set.
+         */
+        static std::shared_ptr<ErrorMonitor> getDefault();
+
+        /**
+         * Record the error bits of a status packet.
+         * @param id the ID of the Dynamixel unit that sent the status packet.
+         * @param flags the error bits of the status packet.
+         */
+        void record(byte id, byte flags);
+
+        /**
+         * @param id the ID of the Dynamixel unit.
+         * @return the error statistics of the unit.
+         */
+        Statistics getStatistics(byte id) const;
+
+        /**
+         * @return the events held by the event ring, oldest first.
+         */
+        std::vector<Event> getEvents() const;
+
+        /**
+         * Clear all statistics and events.
+         */
+        void reset();
+
+        /**
+         * @param flags error bits.
+         * @return a human readable description of the error bits.
+         */
+        static std::string describe(byte flags);
+
+    private:
+        struct State {
+            Statistics statistics;
+            Clock::time_point nextLog;
+            byte loggedFlags = 0;
+            uint32_t suppressed = 0;
+        };
+
+        mutable std::mutex mutex;
+
+        Clock::duration logInterval;
+        std::array<State, MaxId + 1> states;
+
+        std::vector<Event> events;
+        size_t eventCount = 0;
+    };
+}
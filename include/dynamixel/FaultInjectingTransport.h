@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Transport.h"
+#include <deque>
+#include <memory>
+#include <random>
+
+namespace goliath::dynamixel {
+    /**
+     * Transport decorator that corrupts the received bytes, to measure how well the retry logic recovers from a
+     * noisy bus. All faults are drawn from a seeded random number generator, so runs are reproducible.
+     */
+    class FaultInjectingTransport final : public Transport {
+    public:
+        /**
+         * The probabilities of the faults, in range (0, 1).
+         */
+        struct Faults {
+            // Per received byte: one random bit is flipped.
+            double bitFlipRate = 0.0;
+            // Per received byte: the byte is lost.
+            double dropRate = 0.0;
+            // Per received byte: a random byte is inserted before it.
+            double strayRate = 0.0;
+            // Per reply: the reply arrives `delay` late.
+            double delayRate = 0.0;
+            Clock::duration delay = std::chrono::milliseconds(5);
+            // Per written packet: the reply never arrives.
+            double silentRate = 0.0;
+
+            /**
+             * @param factor the factor to multiply all probabilities with.
+             * @return the faults with scaled probabilities.
+             */
+            Faults scaled(double factor) const;
+        };
+
+        /**
+         * The number of faults injected.
+         */
+        struct Statistics {
+            uint64_t bitFlips = 0;
+            uint64_t drops = 0;
+            uint64_t strays = 0;
+            uint64_t delays = 0;
+            uint64_t silences = 0;
+        };
+
+        /**
+         * @param transport the transport that does the actual transfers.
+         * @param faults the faults to inject.
+         * @param seed the seed of the random number generator.
+         */
+        FaultInjectingTransport(std::shared_ptr<Transport> transport, Faults faults, uint32_t seed = 0);
+
+        using Transport::write;
+        using Transport::read;
+
+        size_t write(boost::asio::const_buffer data, boost::system::error_code &error) override;
+
+        size_t write(const std::vector<boost::asio::const_buffer> &buffers, boost::system::error_code &error) override;
+
+        size_t read(boost::asio::mutable_buffer buffer, Clock::time_point deadline,
+                    boost::system::error_code &error) override;
+
+        void flush(FlushType what) override;
+
+        /**
+         * Change the faults to inject.
+         * @param faults the faults.
+         */
+        void setFaults(const Faults &faults);
+
+        const Faults &getFaults() const;
+
+        const Statistics &getStatistics() const;
+
+    private:
+        std::shared_ptr<Transport> transport;
+        Faults faults;
+        Statistics statistics;
+
+        std::mt19937 random;
+        std::uniform_real_distribution<double> chance;
+
+        // Corrupted bytes that were received but not read yet.
+        std::deque<byte> pending;
+        // Whether the next read is the first of a reply, and what happens to that reply.
+        bool replyStarted = true;
+        bool silent = false;
+
+        void startReply();
+
+        void corrupt(const byte *data, size_t size);
+    };
+}
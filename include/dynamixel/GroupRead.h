@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Dynamixel.h"
+#include "State.h"
+
+namespace goliath::dynamixel {
+    /**
+     * Reads the present state (position up to temperature) of several Dynamixel units into a `RawState`, with a
+     * single READ instruction per unit.
+     */
+    class GroupRead {
+    public:
+        /**
+         * @param servos the Dynamixel units to read, in the order of the state arrays.
+         * @param tries how many times a read is retried after an error.
+         */
+        explicit GroupRead(std::vector<std::shared_ptr<Dynamixel>> servos, int tries = 1);
+
+        /**
+         * Read the present state of all units. Units that couldn't be read are marked invalid and keep their
+         * previous values.
+         * @param state the state to fill; it's resized to the number of units.
+         * @return the number of units that were read successfully.
+         */
+        size_t read(RawState &state);
+
+        /**
+         * @return the Dynamixel units read by this group.
+         */
+        const std::vector<std::shared_ptr<Dynamixel>> &getServos() const;
+
+    private:
+        std::vector<std::shared_ptr<Dynamixel>> servos;
+        int tries;
+    };
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Transport.h"
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace goliath::dynamixel {
+    /**
+     * In-memory transport, e.g. for tests, benchmarks and simulators.
+     * Written bytes are recorded (and optionally answered by a responder); read bytes come from a queue that can be
+     * fed from any thread. Every transfer takes a mutex, so a real-time loop on it isn't lock-free.
+     */
+    class MemoryTransport final : public Transport {
+    public:
+        /**
+         * Produces the bytes the bus answers with after a write.
+         */
+        using Responder = std::function<std::vector<byte>(const byte *data, size_t size)>;
+
+        /**
+         * Produces the bytes the bus answers with after a write into `reply`, which is empty on the call and reused
+         * between writes, so answering doesn't allocate once it has grown.
+         */
+        using ReplyWriter = std::function<void(const byte *data, size_t size, std::vector<byte> &reply)>;
+
+        MemoryTransport() = default;
+
+        /**
+         * Construct a memory transport that answers every write through a responder.
+         * @param responder the responder to be called on every write.
+         */
+        explicit MemoryTransport(Responder responder);
+
+        /**
+         * Construct a memory transport that answers every write through a reply writer.
+         * @param writer the reply writer to be called on every write.
+         */
+        explicit MemoryTransport(ReplyWriter writer);
+
+        using Transport::write;
+        using Transport::read;
+
+        size_t write(boost::asio::const_buffer data, boost::system::error_code &error) override;
+
+        size_t read(boost::asio::mutable_buffer buffer, Clock::time_point deadline,
+                    boost::system::error_code &error) override;
+
+        void flush(FlushType what) override;
+
+        /**
+         * Set the responder that's called on every write.
+         * @param responder the responder, or an empty function to disable it.
+         */
+        void setResponder(Responder responder);
+
+        /**
+         * Set the reply writer that's called on every write, replacing the responder.
+         * @param writer the reply writer, or an empty function to disable it.
+         */
+        void setReplyWriter(ReplyWriter writer);
+
+        /**
+         * Record the written bytes for `takeWritten()`, which is the default. Turn it off for long runs, so the
+         * record doesn't grow.
+         * @param recording whether to record.
+         */
+        void setRecording(bool recording);
+
+        /**
+         * Queue bytes to be received by subsequent reads.
+         * @param data the bytes to be received.
+         */
+        void feed(const std::vector<byte> &data);
+
+        /**
+         * Take all bytes written so far.
+         * @return the bytes written since the last call.
+         */
+        std::vector<byte> takeWritten();
+
+    private:
+        std::mutex mutex;
+        std::condition_variable received;
+
+        // Read from the front; erasing doesn't release the capacity.
+        std::vector<byte> rx;
+        std::vector<byte> tx;
+        bool recording = true;
+
+        // Shared, so a write can call it outside the lock without copying the function.
+        std::shared_ptr<const ReplyWriter> writer;
+        std::vector<byte> reply;
+    };
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "GroupRead.h"
+#include "SyncWrite.h"
+
+namespace goliath::dynamixel {
+    /**
+     * Moves several Dynamixel units so that they all start and arrive at the same time.
+     * The present positions are read with a `GroupRead`; the *moving speed* of every unit is then scaled to its
+     * travel, and all goal positions and speeds are sent in a single SYNC WRITE. Acceleration isn't modelled, so
+     * joints only arrive together as far as the units follow their *moving speed*.
+     */
+    class MotionPlanner {
+    public:
+        using byte = Dynamixel::byte;
+        using Clock = Transport::Clock;
+
+        /**
+         * A planned move; index `i` of every array belongs to the unit `ids[i]`.
+         */
+        struct Plan {
+            std::vector<uint8_t> ids;
+            // *Present position* when the move was planned.
+            std::vector<uint16_t> startPosition;
+            std::vector<uint16_t> goalPosition;
+            // *Moving speed* in range (1, 1023).
+            std::vector<uint16_t> movingSpeed;
+            // The expected duration; longer than requested if that would exceed the maximum speed.
+            std::chrono::duration<float> duration{};
+        };
+
+        /**
+         * @param port the transport the units are connected to, used for the SYNC WRITE.
+         * @param servos the Dynamixel units to move, in the order of the target arrays.
+         * @param tries how many times reading a present position is retried after an error.
+         */
+        MotionPlanner(std::shared_ptr<Transport> port, std::vector<std::shared_ptr<Dynamixel>> servos,
+                      int tries = 1);
+
+        /**
+         * Move all units to their targets in the given time, or as fast as the slowest joint allows.
+         * @param goalPosition the *goal position* per unit, in range (0, 1023).
+         * @param duration the time in which all units should arrive.
+         * @return the plan that was sent.
+         * @throws std::invalid_argument if the number of targets doesn't match the number of units.
+         * @throws std::runtime_error if a present position couldn't be read; nothing is sent.
+         * @throws boost::system::system_error if a SYNC WRITE couldn't be sent.
+         */
+        Plan moveIn(const std::vector<uint16_t> &goalPosition, Clock::duration duration);
+
+        /**
+         * Move all units to their targets, the unit with the longest travel at the given velocity.
+         * @param goalPosition the *goal position* per unit, in range (0, 1023).
+         * @param maxVelocity the velocity of the fastest joint in radians per second; at most 114 RPM.
+         * @return the plan that was sent.
+         * @throws std::invalid_argument if the number of targets doesn't match the number of units, or the velocity
+         * isn't positive.
+         * @throws std::runtime_error if a present position couldn't be read; nothing is sent.
+         * @throws boost::system::system_error if a SYNC WRITE couldn't be sent.
+         */
+        Plan moveWithVelocity(const std::vector<uint16_t> &goalPosition, float maxVelocity);
+
+        /**
+         * Compute the *moving speed* per unit so that all units arrive at the same time, without any I/O.
+         * @param plan a plan with the ids, start and goal positions filled in; the speeds and duration are set.
+         * @param duration the requested duration in seconds.
+         */
+        static void schedule(Plan &plan, float duration);
+
+        /**
+         * @param plan a planned move.
+         * @return the SYNC WRITEs of the goal positions and moving speeds of the plan; more than one if the plan
+         * has more units than a single packet takes (see `SyncWrite::getMaxUnits()`).
+         */
+        static std::vector<SyncWrite> getSyncWrites(const Plan &plan);
+
+    private:
+        std::shared_ptr<Transport> port;
+        GroupRead groupRead;
+        RawState state;
+
+        Plan prepare(const std::vector<uint16_t> &goalPosition);
+
+        /**
+         * Send the SYNC WRITEs of a plan.
+         * @throws boost::system::system_error if any error.
+         */
+        void send(const Plan &plan);
+    };
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "Dynamixel.h"
+
+namespace goliath::dynamixel {
+    /**
+     * An instruction packet that is encoded once and then only patched: the header and the checksum of the fixed
+     * bytes are computed up front, and changing a value rewrites just its bytes and adjusts the checksum by the
+     * difference. Meant for commands that are sent every control tick with a new value.
+     */
+    class PreparedPacket {
+    public:
+        using byte = Dynamixel::byte;
+
+        /**
+         * @return the encoded instruction packet, including the current checksum.
+         */
+        const std::vector<byte> &getPacket() const;
+
+        /**
+         * @return the packet as a buffer, e.g. for `TransmitBatch::add()`. It's valid as long as this object.
+         */
+        boost::asio::const_buffer buffer() const;
+
+    protected:
+        /**
+         * Encode the packet with zeroed values.
+         * @param id the ID of the addressed Dynamixel unit, or `Dynamixel::BroadcastId`.
+         * @param instruction the instruction for the Dynamixel actuator to perform.
+         * @param data the packet's parameters.
+         */
+        PreparedPacket(byte id, Dynamixel::Instruction instruction, const std::vector<byte> &data);
+
+        /**
+         * Write a little endian value into the packet and update the checksum.
+         * @param offset the offset of the value in the packet.
+         * @param width the number of bytes of the value.
+         * @param value the value.
+         */
+        void patch(size_t offset, size_t width, uint16_t value);
+
+    private:
+        std::vector<byte> packet;
+        // The sum of the bytes the checksum covers; only the lowest byte matters.
+        unsigned int sum;
+    };
+
+    /**
+     * A prepared WRITE (or REG_WRITE) of a 1 or 2 byte value to one Dynamixel unit, e.g.
+     * `PreparedCommand goal(servo, Dynamixel::Instruction::Write, Dynamixel::Address::GoalPosition, 2);`
+     * `goal.set(position); goal.send();`
+     */
+    class PreparedCommand : public PreparedPacket {
+    public:
+        /**
+         * @param servo the Dynamixel unit to send the command to.
+         * @param instruction `Instruction::Write` or `Instruction::RegWrite`.
+         * @param address the address of the value in the control table.
+         * @param width the number of bytes of the value, 1 or 2.
+         * @throws std::invalid_argument if the width isn't 1 or 2.
+         */
+        PreparedCommand(std::shared_ptr<Dynamixel> servo, Dynamixel::Instruction instruction,
+                        Dynamixel::Address address, size_t width);
+
+        /**
+         * Change the value written by the command.
+         * @param value the value.
+         */
+        void set(uint16_t value);
+
+        /**
+         * Send the command and receive the status packet.
+         * @param tries how many times the transaction is retried after an error.
+         * @return the error of the last try, if any.
+         */
+        Result<void> send(int tries = 5);
+
+    private:
+        std::shared_ptr<Dynamixel> servo;
+        size_t width;
+    };
+
+    /**
+     * A prepared SYNC WRITE of a 1 or 2 byte value to a fixed set of Dynamixel units. Only the values of units that
+     * changed are patched.
+     */
+    class PreparedSyncWrite : public PreparedPacket {
+    public:
+        /**
+         * @param address the address of the value in the control table.
+         * @param width the number of bytes of the value, 1 or 2.
+         * @param ids the IDs of the Dynamixel units, in the order of their values.
+         * @throws std::invalid_argument if the width isn't 1 or 2, or there are more units than fit in one SYNC
+         * WRITE (see `SyncWrite::getMaxUnits()`).
+         */
+        PreparedSyncWrite(Dynamixel::Address address, size_t width, const std::vector<byte> &ids);
+
+        /**
+         * Change the value of one unit.
+         * @param index the index of the unit in the IDs.
+         * @param value the value.
+         * @throws std::out_of_range if the index isn't less than `size()`.
+         */
+        void set(size_t index, uint16_t value);
+
+        /**
+         * Change the values of all units, e.g. the result of a batch conversion.
+         * @param values the value per unit.
+         */
+        void set(const uint16_t *values);
+
+        /**
+         * @return the number of units written to.
+         */
+        size_t size() const;
+
+        /**
+         * Send the packet. The packet is broadcast, so no status packet is returned.
+         * @param port the transport to send the packet through.
+         * @throws boost::system::system_error if any error.
+         */
+        void send(Transport &port) const;
+
+    private:
+        size_t width;
+        size_t units;
+
+        /**
+         * Change the value of one unit, without checking the index.
+         */
+        void patchUnit(size_t index, uint16_t value);
+    };
+}
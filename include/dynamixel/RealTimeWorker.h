@@ -0,0 +1,179 @@
+#pragma once
+
+#include "Arena.h"
+#include "State.h"
+#include "Telemetry.h"
+#include "Transport.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace goliath::dynamixel {
+    /**
+     * Runs the control loop of a bus on a dedicated real-time thread: every period the changed goal positions are
+     * sent in one SYNC WRITE, after which the state of every unit is read (see `GroupRead`).
+     * All buffers of the loop are carved from an `Arena` when the worker is constructed, and the packets are
+     * built and parsed in place, so once the loop runs it neither allocates nor takes locks. Goals and state are
+     * exchanged with other threads lock-free.
+     *
+     * That only holds for the transfers if the transport doesn't allocate or lock either. `SerialPort` polls its
+     * descriptor for reads and doesn't log, also when a read times out; `MemoryTransport` takes a mutex on every
+     * transfer, so it's only fit for simulations.
+     *
+     * Failed transfers aren't retried within a cycle, the next cycle simply tries again. The direction callback
+     * of `Dynamixel` isn't supported; use an adapter that switches direction by itself, possibly with an
+     * `EchoCancellingTransport`.
+     */
+    class RealTimeWorker {
+    public:
+        using Clock = std::chrono::steady_clock;
+        using byte = unsigned char;
+
+        struct Config {
+            // The period of the loop, 2 ms for 500 Hz.
+            Clock::duration period = std::chrono::milliseconds(2);
+            // The SCHED_FIFO priority (1..99) of the loop, or 0 to keep the default scheduling policy.
+            int priority = 0;
+            // The CPU to pin the loop to, or -1 for any.
+            int cpu = -1;
+            // Lock all current and future pages of the process in memory, so the loop never page faults.
+            bool lockMemory = true;
+            // The size of the arena in bytes.
+            size_t arenaSize = 64 * 1024;
+            // The number of cycles after which the loop is expected to no longer allocate.
+            uint64_t warmupCycles = 100;
+            // Abort on an allocation or a lock after the warmup, see `AllocationCounter::watch()`.
+            bool trapAllocations = false;
+        };
+
+        struct Statistics {
+            uint64_t cycles = 0;
+            // Cycles that didn't finish within their period.
+            uint64_t overruns = 0;
+            // Failed transfers.
+            uint64_t errors = 0;
+            // The longest delay between the scheduled start of a cycle and the loop waking up.
+            Clock::duration worstLatency = Clock::duration::zero();
+            // The longest time a cycle took.
+            Clock::duration worstCycle = Clock::duration::zero();
+            // Allocations of the loop after the warmup; only counted if the allocation hook is installed, see
+            // `AllocationCounter`.
+            uint64_t allocations = 0;
+            // Locks taken by the loop after the warmup; likewise only counted if the hook is installed.
+            uint64_t locks = 0;
+        };
+
+        /**
+         * @param transport the transport of the bus, used exclusively by the worker while it runs.
+         * @param ids the IDs of the units to control.
+         * @param config the configuration of the loop.
+         * @throws std::invalid_argument if there are no units or the period isn't positive.
+         * @throws std::bad_alloc if the arena is too small for the units.
+         */
+        RealTimeWorker(std::shared_ptr<Transport> transport, const std::vector<byte> &ids, const Config &config);
+
+        RealTimeWorker(std::shared_ptr<Transport> transport, const std::vector<byte> &ids);
+
+        RealTimeWorker(const RealTimeWorker &) = delete;
+
+        RealTimeWorker &operator=(const RealTimeWorker &) = delete;
+
+        ~RealTimeWorker();
+
+        /**
+         * Publish the state read by every cycle. Must be called before `start()`.
+         * @param publisher the publisher, with room for all units.
+         */
+        void setTelemetry(std::shared_ptr<TelemetryPublisher> publisher);
+
+        /**
+         * Lock the memory of the process and start the loop.
+         * @throws boost::system::system_error if the memory can't be locked, or the priority or affinity can't be
+         * set (e.g. for lack of CAP_SYS_NICE or a suitable RLIMIT_RTPRIO).
+         * @throws std::logic_error if the loop is running already.
+         */
+        void start();
+
+        /**
+         * Stop the loop and wait for it to finish its cycle.
+         */
+        void stop();
+
+        bool isRunning() const;
+
+        /**
+         * Set the goal position of a unit, sent with the next cycle. Lock-free.
+         * @param index the index of the unit in the IDs passed to the constructor.
+         * @param position the goal position in range (0, 1023).
+         */
+        void setGoalPosition(size_t index, uint16_t position);
+
+        /**
+         * Copy the state read by the last cycle. Lock-free; the copy is retried while a cycle publishes its state.
+         * @param state receives the state; it's resized to the number of units.
+         * @return true if a cycle has completed; otherwise, false and the values of the state are left alone.
+         */
+        bool getState(RawState &state) const;
+
+        Statistics getStatistics() const;
+
+    private:
+        std::shared_ptr<Transport> transport;
+        Config config;
+        size_t count;
+        std::shared_ptr<TelemetryPublisher> telemetry;
+
+        Arena arena;
+        // Goal positions, with `Dirty` set if they weren't sent yet.
+        std::atomic<uint32_t> *goals;
+        // The SYNC WRITE packet, filled with the dirty goals every cycle.
+        byte *syncWrite;
+        // A READ DATA packet per unit.
+        byte *readPackets;
+        byte *statusPacket;
+
+        // Filled by the cycle, then copied to `shared` for other threads.
+        RawState state;
+        // The state packed into a few words per unit, so other threads can copy it without a data race.
+        std::atomic<uint64_t> *shared;
+        // Sequence lock of `shared`: odd while it's written.
+        std::atomic<uint64_t> sharedSequence{0};
+
+        std::atomic<bool> running{false};
+        std::thread thread;
+
+        std::atomic<uint64_t> cycles{0};
+        std::atomic<uint64_t> overruns{0};
+        std::atomic<uint64_t> errors{0};
+        std::atomic<Clock::rep> worstLatency{0};
+        std::atomic<Clock::rep> worstCycle{0};
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> locks{0};
+
+        /**
+         * Apply the priority and affinity to the calling thread.
+         * @throws boost::system::system_error if any error.
+         */
+        void configureThread();
+
+        /**
+         * The loop.
+         * @param ready satisfied once the thread is configured, or with the configuration error.
+         */
+        void run(std::promise<void> &ready);
+
+        void cycle();
+
+        void sendGoals();
+
+        /**
+         * Read the state of a unit into `state`.
+         * @return the error, if any.
+         */
+        boost::system::error_code readState(size_t index);
+    };
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "CaptureFile.h"
+#include "Transport.h"
+#include <deque>
+
+namespace goliath::dynamixel {
+    /**
+     * Transport that plays the received packets of a capture back to the parser.
+     * Every write consumes the next captured transmission and schedules the receptions that followed it, with their
+     * original delays divided by the replay speed.
+     */
+    class ReplayTransport final : public Transport {
+    public:
+        /**
+         * @param packets the captured packets, oldest first.
+         * @param speed the replay speed, e.g. 1 for the original timing or 10 to replay ten times as fast. Zero
+         * replays without any delays.
+         */
+        explicit ReplayTransport(std::vector<CapturedPacket> packets, double speed = 1.0);
+
+        using Transport::write;
+        using Transport::read;
+
+        size_t write(boost::asio::const_buffer data, boost::system::error_code &error) override;
+
+        size_t read(boost::asio::mutable_buffer buffer, Clock::time_point deadline,
+                    boost::system::error_code &error) override;
+
+        void flush(FlushType what) override;
+
+        /**
+         * @return the number of writes that differed from the captured transmission they replaced.
+         */
+        size_t getMismatches() const;
+
+        /**
+         * @return true if all captured transmissions have been replayed; otherwise, false.
+         */
+        bool isFinished() const;
+
+        /**
+         * Write the captured transmissions to another transport, e.g. a simulated bus, with their original spacing
+         * divided by the replay speed.
+         * @param packets the captured packets, oldest first.
+         * @param transport the transport to write to.
+         * @param speed the replay speed, zero replays without any delays.
+         * @return the number of packets written.
+         * @throws boost::system::system_error if any error.
+         */
+        static size_t transmit(const std::vector<CapturedPacket> &packets, Transport &transport, double speed = 1.0);
+
+    private:
+        struct Pending {
+            Clock::time_point due;
+            byte value;
+        };
+
+        std::vector<CapturedPacket> packets;
+        double speed;
+
+        size_t position = 0;
+        size_t mismatches = 0;
+        std::deque<Pending> pending;
+
+        Clock::duration scale(Clock::duration delay) const;
+    };
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <boost/system/error_code.hpp>
+#include <boost/system/system_error.hpp>
+#include <type_traits>
+#include <utility>
+
+namespace goliath::dynamixel {
+    /**
+     * Errors of a transaction with a Dynamixel unit.
+     */
+    enum class Errc {
+        // No status packet was received in time.
+        Timeout = 1,
+        // The status packet was cut off.
+        IncompletePacket,
+        // The status packet didn't start with [0xFF, 0xFF].
+        WrongHeader,
+        // The status packet was sent by another unit.
+        WrongId,
+        // The checksum of the status packet didn't match.
+        InvalidChecksum,
+        // The status packet didn't carry the requested number of parameters, e.g. because the unit reported an
+        // error instead.
+        UnexpectedLength,
+        // The echo of the transmitted bytes didn't match them, e.g. because another device was sending.
+        BusContention
+    };
+}
+
+namespace boost::system {
+    template<>
+    struct is_error_code_enum<goliath::dynamixel::Errc> : std::true_type {
+    };
+}
+
+namespace goliath::dynamixel {
+    /**
+     * @return the error category of `Errc` values.
+     */
+    const boost::system::error_category &getErrorCategory();
+
+    boost::system::error_code make_error_code(Errc error);
+
+    /**
+     * Either the value of a successful transaction or its error. It carries the error bits of the status packet
+     * (see `Dynamixel::Error`) in both cases, as units report errors such as overheating along with valid data.
+     * @tparam T the type of the value.
+     */
+    template<typename T>
+    class Result {
+    public:
+        using byte = unsigned char;
+
+        Result(T value, byte servoError = 0) : val(std::move(value)), servoErr(servoError) {
+        }
+
+        Result(boost::system::error_code error, byte servoError = 0) : err(error), servoErr(servoError) {
+        }
+
+        Result(Errc error, byte servoError = 0) : err(make_error_code(error)), servoErr(servoError) {
+        }
+
+        /**
+         * @return true if the transaction succeeded; otherwise, false.
+         */
+        bool ok() const {
+            return !err;
+        }
+
+        explicit operator bool() const {
+            return ok();
+        }
+
+        /**
+         * @return the value of the transaction.
+         * @throws boost::system::system_error if the transaction failed.
+         */
+        const T &value() const & {
+            if (err) {
+                throw boost::system::system_error(err);
+            }
+            return val;
+        }
+
+        T &&value() && {
+            if (err) {
+                throw boost::system::system_error(err);
+            }
+            return std::move(val);
+        }
+
+        /**
+         * @param fallback the value returned if the transaction failed.
+         * @return the value of the transaction, or the fallback.
+         */
+        T valueOr(T fallback) const {
+            return err ? std::move(fallback) : val;
+        }
+
+        /**
+         * @return the error of the transaction, empty if it succeeded.
+         */
+        boost::system::error_code error() const {
+            return err;
+        }
+
+        /**
+         * @return the error bits of the status packet.
+         */
+        byte servoError() const {
+            return servoErr;
+        }
+
+    private:
+        T val{};
+        boost::system::error_code err;
+        byte servoErr = 0;
+    };
+
+    template<>
+    class Result<void> {
+    public:
+        using byte = unsigned char;
+
+        Result(byte servoError = 0) : servoErr(servoError) {
+        }
+
+        Result(boost::system::error_code error, byte servoError = 0) : err(error), servoErr(servoError) {
+        }
+
+        Result(Errc error, byte servoError = 0) : err(make_error_code(error)), servoErr(servoError) {
+        }
+
+        bool ok() const {
+            return !err;
+        }
+
+        explicit operator bool() const {
+            return ok();
+        }
+
+        /**
+         * @throws boost::system::system_error if the transaction failed.
+         */
+        void value() const {
+            if (err) {
+                throw boost::system::system_error(err);
+            }
+        }
+
+        boost::system::error_code error() const {
+            return err;
+        }
+
+        byte servoError() const {
+            return servoErr;
+        }
+
+    private:
+        boost::system::error_code err;
+        byte servoErr = 0;
+    };
+}
@@ -1,22 +1,16 @@
 #pragma once
 
+#include "Transport.h"
 #include <boost/log/trivial.hpp>
 #include <boost/format.hpp>
 #include <boost/thread.hpp>
 #include <boost/asio.hpp>
 
 namespace goliath::dynamixel {
-    class SerialPort {
+    class SerialPort final : public Transport {
     public:
         using TimerType = boost::asio::steady_timer;
 
-        enum class FlushType
-        {
-            Receive = TCIFLUSH,
-            Send = TCOFLUSH,
-            Both = TCIOFLUSH
-        };
-
         /**
          * Construct a serial port without opening it.
          */
@@ -25,7 +19,7 @@ namespace goliath::dynamixel {
         /**
          * Destroys the serial port.
          */
-        ~SerialPort();
+        ~SerialPort() override;
 
         /**
          * Create a serial connection with Dynamixel actuators.
@@ -41,44 +35,57 @@ namespace goliath::dynamixel {
         void close();
 
         /**
-         * Set the timeout on read operations.
-         * @param t duration for the timeout.
+         * Change the baud rate of the open serial port.
+         * @param baud the new baud rate speed.
+         * @throws boost::system::system_error if any error.
          */
-        void setTimeout(const TimerType::duration &t);
+        void setBaudRate(unsigned int baud);
 
         /**
-         * Write the supplied data to a serial device.
-         * @param data to be sent through the serial device.
-         * @return the number of characters written.
+         * @return the baud rate of the open serial port.
          * @throws boost::system::system_error if any error.
          */
-        size_t write(const std::vector<unsigned char> &data);
+        unsigned int getBaudRate() const;
+
+        using Transport::write;
+        using Transport::read;
+
+        size_t write(boost::asio::const_buffer data, boost::system::error_code &error) override;
 
         /**
-         * Read a certain amount of data from the serial device.
-         * @param size how much data to read.
-         * @return the receive buffer. It's empty if no data is available.
-         * @throws boost::system::system_error if any error.
+         * Write several buffers with a single vectored write.
          */
-        std::vector<unsigned char> read(size_t size);
-
-    private:
-        boost::asio::io_service io;
-        std::unique_ptr<boost::asio::serial_port> port;
+        size_t write(const std::vector<boost::asio::const_buffer> &buffers, boost::system::error_code &error) override;
 
-        TimerType::duration timeout;
+        /**
+         * Poll the descriptor until the buffer is filled or the deadline passes. Unlike the asynchronous operations,
+         * this neither allocates nor takes locks, so it's fit for a real-time loop (see `RealTimeWorker`).
+         */
+        size_t read(boost::asio::mutable_buffer buffer, Clock::time_point deadline,
+                    boost::system::error_code &error) override;
 
         /**
          * Flush a serial port's buffers.
          * @param what determines the buffers to flush.
          * @throws boost::system::system_error if any error.
          */
-        void flush(FlushType what);
+        void flush(FlushType what) override;
+
+        /**
+         * The io_service drives the coroutine API (see `AsyncBus`). The blocking operations use the descriptor
+         * directly, so don't mix them with asynchronous operations in flight.
+         * @return the io_service of the serial port.
+         */
+        boost::asio::io_service &getIoService();
 
         /**
-         * https://stackoverflow.com/a/25018876/1480019
+         * The asio serial port, for asynchronous operations on the io_service (see `AsyncBus`).
+         * @return the serial port.
          */
-        template<typename MutableBufferSequence>
-        void readWithTimeout(const MutableBufferSequence &buffer);
+        boost::asio::serial_port &getSerialPort();
+
+    private:
+        boost::asio::io_service io;
+        std::unique_ptr<boost::asio::serial_port> port;
     };
-}
\ No newline at end of file
+}
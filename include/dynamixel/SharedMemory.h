@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace goliath::dynamixel {
+    /**
+     * A mapping of a POSIX shared memory object (`shm_open()`), shared between the processes of a machine.
+     */
+    class SharedMemory {
+    public:
+        enum class Access {
+            // Create (or replace) the object; it's removed again when the creator is destroyed.
+            Create,
+            // Map an existing object read-only.
+            ReadOnly,
+            // Map an existing object for reading and writing.
+            ReadWrite
+        };
+
+        /**
+         * @param name the name of the object, e.g. "/dynamixel-telemetry".
+         * @param access how to open the object.
+         * @param size the size of a created object; ignored when opening an existing one.
+         * @throws boost::system::system_error if the object can't be opened or mapped.
+         */
+        SharedMemory(std::string name, Access access, size_t size = 0);
+
+        ~SharedMemory();
+
+        SharedMemory(const SharedMemory &) = delete;
+
+        SharedMemory &operator=(const SharedMemory &) = delete;
+
+        void *data() const;
+
+        size_t size() const;
+
+        const std::string &getName() const;
+
+    private:
+        std::string name;
+        bool owner;
+        void *mapping;
+        size_t mappedSize;
+    };
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace goliath::dynamixel {
+    /**
+     * The present state of a set of Dynamixel units as raw control table values, one array per quantity
+     * (structure of arrays). Index `i` of every array belongs to the unit `ids[i]`.
+     */
+    struct RawState {
+        std::vector<uint8_t> ids;
+        // *Present position* in range (0, 1023).
+        std::vector<uint16_t> position;
+        // *Present speed*, bit 10 is the direction (set is clockwise).
+        std::vector<uint16_t> speed;
+        // *Present load*, bit 10 is the direction (set is clockwise).
+        std::vector<uint16_t> load;
+        // *Present voltage* in 0.1 Volt.
+        std::vector<uint8_t> voltage;
+        // *Present temperature* in degrees Celsius.
+        std::vector<uint8_t> temperature;
+        // Error bits of the last status packet.
+        std::vector<uint8_t> errors;
+        // Non-zero if the values were read successfully.
+        std::vector<uint8_t> valid;
+        // When the instruction packet of the read started to be sent (monotonic clock).
+        std::vector<std::chrono::steady_clock::time_point> transmitted;
+        // When the status packet of the read was completely received (monotonic clock).
+        std::vector<std::chrono::steady_clock::time_point> received;
+
+        /**
+         * Resize all arrays.
+         * @param size the number of units.
+         */
+        void resize(size_t size) {
+            ids.resize(size);
+            position.resize(size);
+            speed.resize(size);
+            load.resize(size);
+            voltage.resize(size);
+            temperature.resize(size);
+            errors.resize(size);
+            valid.resize(size);
+            transmitted.resize(size);
+            received.resize(size);
+        }
+
+        size_t size() const {
+            return ids.size();
+        }
+    };
+
+    /**
+     * The present state of a set of joints in SI units, counter clockwise being positive.
+     */
+    struct JointState {
+        // Angle in radians.
+        std::vector<float> position;
+        // Angular velocity in radians per second.
+        std::vector<float> velocity;
+        // Load as a fraction of the maximum torque, in range (-1, 1).
+        std::vector<float> effort;
+        // Supply voltage in Volts.
+        std::vector<float> voltage;
+        // Internal temperature in degrees Celsius.
+        std::vector<float> temperature;
+
+        void resize(size_t size) {
+            position.resize(size);
+            velocity.resize(size);
+            effort.resize(size);
+            voltage.resize(size);
+            temperature.resize(size);
+        }
+
+        size_t size() const {
+            return position.size();
+        }
+    };
+
+    /**
+     * Per-joint calibration applied when converting between raw values and joint space:
+     * `joint = direction * (raw - center) * scale + offset`.
+     */
+    struct Calibration {
+        // Joint angle in radians at the center position (512).
+        std::vector<float> offset;
+        // 1 if the joint turns with the unit, -1 if it's mirrored.
+        std::vector<float> direction;
+
+        /**
+         * Resize the arrays, new joints are neither offset nor mirrored.
+         * @param size the number of joints.
+         */
+        void resize(size_t size) {
+            offset.resize(size, 0.0f);
+            direction.resize(size, 1.0f);
+        }
+
+        size_t size() const {
+            return offset.size();
+        }
+    };
+}
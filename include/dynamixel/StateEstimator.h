@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Dynamixel.h"
+#include "State.h"
+
+namespace goliath::dynamixel {
+    /**
+     * Estimates the position and velocity of one Dynamixel unit from timestamped *present position* samples, with
+     * an alpha-beta filter. Every sample is placed at the time the unit sampled it (see `Dynamixel::Timing`), not
+     * at the time it was received, so the variable turnaround of the bus doesn't show up as velocity noise. This
+     * gives a smoother velocity than the coarse *present speed* of the AX-12, without extra reads.
+     * Positions are in ticks and velocities in ticks per second; multiply by `Conversion::RadiansPerTick` for
+     * radians.
+     */
+    class StateEstimator {
+    public:
+        using Clock = Transport::Clock;
+
+        /**
+         * @param alpha the gain of the position correction, in range (0, 1]; higher follows samples more closely.
+         * @param beta the gain of the velocity correction, in range (0, 2); higher reacts faster to acceleration.
+         * @param timeout the longest gap between samples; after a longer one the filter starts over.
+         */
+        explicit StateEstimator(float alpha = 0.5f, float beta = 0.1f,
+                                Clock::duration timeout = std::chrono::milliseconds(200));
+
+        /**
+         * Add a sample. Samples that are not newer than the previous one are ignored.
+         * @param position the *present position*.
+         * @param sampled the time the unit sampled the position.
+         */
+        void update(uint16_t position, Clock::time_point sampled);
+
+        /**
+         * Add the sample of the last read of a unit, e.g. after `Dynamixel::getPresentPosition()`.
+         * @param position the *present position*.
+         * @param timing the timestamps of the read, see `Dynamixel::getLastTiming()`.
+         */
+        void update(uint16_t position, const Dynamixel::Timing &timing);
+
+        /**
+         * Add a sample of a `GroupRead`. Invalid samples are ignored; the *present speed* initializes the velocity.
+         * @param state the state read.
+         * @param index the index of the unit in the state.
+         */
+        void update(const RawState &state, size_t index);
+
+        /**
+         * @return true if at least one sample has been added since the last reset; otherwise, false.
+         */
+        bool isInitialized() const;
+
+        /**
+         * @return the estimated position at the time of the last sample.
+         */
+        float getPosition() const;
+
+        /**
+         * @param time the time to extrapolate to, e.g. `Clock::now()`.
+         * @return the estimated position at the given time.
+         */
+        float getPosition(Clock::time_point time) const;
+
+        /**
+         * @return the estimated velocity.
+         */
+        float getVelocity() const;
+
+        /**
+         * @return the time of the last sample.
+         */
+        Clock::time_point getTime() const;
+
+        /**
+         * Forget all samples.
+         */
+        void reset();
+
+    private:
+        float alpha;
+        float beta;
+        Clock::duration timeout;
+
+        bool initialized = false;
+        float position = 0.0f;
+        float velocity = 0.0f;
+        Clock::time_point time;
+
+        void initialize(float position, float velocity, Clock::time_point sampled);
+    };
+}
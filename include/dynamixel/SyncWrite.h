@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Dynamixel.h"
+
+namespace goliath::dynamixel {
+    /**
+     * Builds a SYNC WRITE packet, which writes the same control table range of several Dynamixel units at once.
+     * The packet is broadcast, so no status packet is returned.
+     * (see the official Dynamixel AX-12 User's manual p.32)
+     */
+    class SyncWrite {
+    public:
+        using byte = Dynamixel::byte;
+
+        /**
+         * @param address the starting address of the location where the data is to be written.
+         * @param length the number of bytes written to every unit.
+         * @throws std::invalid_argument if not even one unit fits in a packet.
+         */
+        SyncWrite(Dynamixel::Address address, size_t length);
+
+        /**
+         * @param length the number of bytes written to every unit.
+         * @return the number of units a single SYNC WRITE packet can write to, e.g. 83 for 2 bytes.
+         */
+        static size_t getMaxUnits(size_t length);
+
+        /**
+         * Add the data for a Dynamixel unit.
+         * @param id the ID of the Dynamixel unit.
+         * @param data the bytes to be written; exactly `length` of them.
+         * @throws std::invalid_argument if the data has the wrong length, or the packet is full.
+         */
+        void add(byte id, const std::vector<byte> &data);
+
+        /**
+         * Add a 2 byte value for a Dynamixel unit.
+         * @param id the ID of the Dynamixel unit.
+         * @param value the value to be written.
+         * @throws std::invalid_argument if the packet doesn't write 2 bytes per unit, or is full.
+         */
+        void add(byte id, uint16_t value);
+
+        /**
+         * Add 2 byte values for several Dynamixel units, e.g. the result of a batch conversion.
+         * @param ids the IDs of the Dynamixel units.
+         * @param values the value to be written per unit.
+         * @throws std::invalid_argument if the packet doesn't write 2 bytes per unit, or the units don't fit.
+         */
+        void add(const std::vector<uint8_t> &ids, const uint16_t *values);
+
+        /**
+         * @return the number of units written to.
+         */
+        size_t size() const;
+
+        /**
+         * @return true if no unit is written to; otherwise, false.
+         */
+        bool empty() const;
+
+        /**
+         * Remove all units.
+         */
+        void clear();
+
+        /**
+         * @return the SYNC WRITE instruction packet.
+         */
+        std::vector<byte> getPacket() const;
+
+        /**
+         * Send the packet, if any unit is written to.
+         * @param port the transport to send the packet through.
+         * @throws boost::system::system_error if any error.
+         */
+        void send(Transport &port) const;
+
+    private:
+        Dynamixel::Address address;
+        size_t length;
+        size_t maxUnits;
+
+        // [ID, data...] per unit
+        std::vector<byte> params;
+
+        /**
+         * @throws std::invalid_argument if the packet can't take another unit.
+         */
+        void checkRoom() const;
+    };
+}
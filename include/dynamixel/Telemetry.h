@@ -0,0 +1,151 @@
+#pragma once
+
+#include "SharedMemory.h"
+#include "State.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace goliath::dynamixel {
+    /**
+     * The header of a telemetry region, followed by a ring of `capacity` slots of `slotSize` bytes.
+     */
+    struct TelemetryHeader {
+        static constexpr char Magic[8] = {'D', 'X', 'L', 'T', 'L', 'M', 0, 0};
+        static constexpr uint32_t CurrentVersion = 2;
+
+        char magic[8];
+        uint32_t version;
+        uint32_t slotSize;
+        uint32_t capacity;
+        uint32_t servoCount;
+        // Number of samples ever published; the ring holds the last `capacity` of them.
+        std::atomic<uint64_t> published;
+        uint64_t padding[4];
+    };
+
+    static_assert(sizeof(TelemetryHeader) == 64, "telemetry header must stay 64 bytes");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "telemetry requires lock-free 64 bit atomics");
+
+    /**
+     * The state of one unit in a telemetry slot, the raw control table values and timestamps of `RawState`.
+     */
+    struct TelemetryServo {
+        // Nanoseconds of the monotonic clock, see `RawState::transmitted` and `RawState::received`.
+        uint64_t transmitted;
+        uint64_t received;
+        uint8_t id;
+        uint8_t error;
+        uint8_t valid;
+        uint8_t voltage;
+        uint8_t temperature;
+        uint8_t reserved;
+        uint16_t position;
+        uint16_t speed;
+        uint16_t load;
+        uint32_t padding;
+    };
+
+    static_assert(sizeof(TelemetryServo) == 32, "telemetry servos must stay 32 bytes");
+
+    /**
+     * A slot of the telemetry ring, followed by `servoCount` servos. Slots are padded to whole cache lines.
+     */
+    struct TelemetrySlot {
+        // Sequence lock: odd while the slot is written, `2 * (sample + 1)` once sample `sample` is complete.
+        std::atomic<uint64_t> sequence;
+        // Nanoseconds of the monotonic clock at which the sample was taken.
+        uint64_t timestamp;
+    };
+
+    static_assert(sizeof(TelemetrySlot) == 16, "telemetry slots must stay 16 bytes");
+
+    /**
+     * Publishes the polled state of a bus into a shared memory ring. Only the publishing process accesses the bus;
+     * any number of `TelemetryReader`s in other processes read the samples without system calls or serialization.
+     * A publisher is not thread safe, samples must be published by one thread.
+     */
+    class TelemetryPublisher {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /**
+         * Create the shared memory region; an existing region of the same name is replaced.
+         * @param name the name of the shared memory object, e.g. "/dynamixel-telemetry".
+         * @param servoCount the number of units per sample.
+         * @param capacity the number of samples held by the ring.
+         * @throws std::invalid_argument if the capacity is zero.
+         * @throws boost::system::system_error if the region can't be created.
+         */
+        TelemetryPublisher(const std::string &name, size_t servoCount, size_t capacity = 256);
+
+        /**
+         * Publish a sample.
+         * @param state the state to publish; units beyond the servo count of the region are left out.
+         * @param time the time the state was read.
+         */
+        void publish(const RawState &state, Clock::time_point time = Clock::now());
+
+        /**
+         * @return the number of samples published.
+         */
+        uint64_t getPublished() const;
+
+    private:
+        SharedMemory memory;
+        TelemetryHeader *header;
+    };
+
+    /**
+     * Reads the samples of a `TelemetryPublisher`, possibly in another process.
+     */
+    class TelemetryReader {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /**
+         * Map an existing telemetry region read-only.
+         * @param name the name of the shared memory object.
+         * @throws boost::system::system_error if the region doesn't exist or can't be mapped.
+         * @throws std::runtime_error if the region is no telemetry region of a supported version.
+         */
+        explicit TelemetryReader(const std::string &name);
+
+        /**
+         * @return the number of samples published so far; sample `getPublished() - 1` is the latest one.
+         */
+        uint64_t getPublished() const;
+
+        /**
+         * @return the number of samples held by the ring.
+         */
+        size_t getCapacity() const;
+
+        /**
+         * @return the number of units per sample.
+         */
+        size_t getServoCount() const;
+
+        /**
+         * Copy a sample, if it's still held by the ring.
+         * @param sample the number of the sample, counting from 0.
+         * @param state receives the sample; it's resized to the number of units.
+         * @param time receives the time the sample was taken.
+         * @return true if the sample was read; false if it isn't published yet or has been overwritten, in which
+         * case `state` may hold a partial copy.
+         */
+        bool read(uint64_t sample, RawState &state, Clock::time_point &time) const;
+
+        /**
+         * Copy the latest sample.
+         * @param state receives the sample; it's resized to the number of units.
+         * @param time receives the time the sample was taken.
+         * @return true if a sample was read; false if nothing has been published yet.
+         */
+        bool readLatest(RawState &state, Clock::time_point &time) const;
+
+    private:
+        SharedMemory memory;
+        const TelemetryHeader *header;
+    };
+}
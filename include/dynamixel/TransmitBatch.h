@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Dynamixel.h"
+
+namespace goliath::dynamixel {
+    /**
+     * Queue of instruction packets that are transmitted together with a single vectored write.
+     * Meant for bursts of commands that don't return a status packet, e.g. writes to units with a status return
+     * level below 2, REG_WRITE/ACTION sequences or broadcasts.
+     * The direction callback of `Dynamixel` is not used; on such hardware toggle the direction around `send()`.
+     */
+    class TransmitBatch {
+    public:
+        using byte = Dynamixel::byte;
+
+        /**
+         * Construct an empty batch.
+         * @param port the transport the batch is sent through.
+         */
+        explicit TransmitBatch(std::shared_ptr<Transport> port);
+
+        /**
+         * Encode and queue an instruction packet.
+         * @param id the ID of the addressed Dynamixel unit, or `Dynamixel::BroadcastId`.
+         * @param instruction the instruction for the Dynamixel actuator to perform.
+         * @param data a vector of bytes containing the packet's parameters.
+         */
+        void add(byte id, Dynamixel::Instruction instruction, const std::vector<byte> &data);
+
+        /**
+         * Queue an already encoded instruction packet.
+         * @param packet the instruction packet.
+         */
+        void add(std::vector<byte> packet);
+
+        /**
+         * Queue a buffer owned by the caller, e.g. a prepared packet. The buffer must stay valid until `send()`
+         * returns.
+         * @param packet the instruction packet.
+         */
+        void add(boost::asio::const_buffer packet);
+
+        /**
+         * @return the number of queued packets.
+         */
+        size_t size() const;
+
+        /**
+         * @return true if no packets are queued; otherwise, false.
+         */
+        bool empty() const;
+
+        /**
+         * Drop all queued packets.
+         */
+        void clear();
+
+        /**
+         * Transmit all queued packets with a single vectored write and clear the batch. The write holds the bus
+         * lock; hold it around this call as well when reading the replies (see `Transport::getBusMutex()`).
+         * @param expectReply flush the receive buffer first, because a status packet is read afterwards.
+         * @return the number of bytes written.
+         * @throws boost::system::system_error if any error.
+         */
+        size_t send(bool expectReply = false);
+
+    private:
+        std::shared_ptr<Transport> port;
+
+        std::vector<std::vector<byte>> packets;
+        std::vector<boost::asio::const_buffer> buffers;
+    };
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <boost/asio/buffer.hpp>
+#include <boost/system/error_code.hpp>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+namespace goliath::dynamixel {
+    /**
+     * Abstract byte transport between the host and a Dynamixel bus.
+     * Implementations only have to provide the three primitives (write, read with a deadline and flush);
+     * the convenience overloads are built on top of them.
+     *
+     * `Dynamixel` and the group classes hold a `std::shared_ptr<Transport>`, so every transfer is a virtual call.
+     * The implementations are `final`, which only lets the compiler devirtualize calls made through the concrete
+     * type; there's no statically typed variant of `Dynamixel`.
+     *
+     * Threads may share a transport: `Dynamixel` holds the bus lock (see `getBusMutex()`) for a whole transaction,
+     * and `SyncWrite`, `PreparedSyncWrite`, `TransmitBatch` and `WriteBatcher` send their packets under it, so no
+     * packet lands between an instruction and its status packet. The coroutine API and `RealTimeWorker` don't take
+     * it; they need the transport to themselves.
+     */
+    class Transport {
+    public:
+        using byte = unsigned char;
+        using Clock = std::chrono::steady_clock;
+
+        enum class FlushType {
+            Receive,
+            Send,
+            Both
+        };
+
+        Transport();
+
+        virtual ~Transport() = default;
+
+        /**
+         * Write the supplied bytes to the bus.
+         * @param data the bytes to be sent.
+         * @param error set to indicate what error occurred, if any.
+         * @return the number of bytes written.
+         */
+        virtual size_t write(boost::asio::const_buffer data, boost::system::error_code &error) = 0;
+
+        /**
+         * Write several buffers to the bus as one gathered write.
+         * The default implementation writes the buffers one by one.
+         * @param buffers the buffers to be sent, in order.
+         * @param error set to indicate what error occurred, if any.
+         * @return the number of bytes written.
+         */
+        virtual size_t write(const std::vector<boost::asio::const_buffer> &buffers, boost::system::error_code &error);
+
+        /**
+         * Fill the supplied buffer with bytes from the bus.
+         * @param buffer the buffer to be filled completely.
+         * @param deadline point in time after which the read is abandoned.
+         * @param error set to indicate what error occurred, if any. A read that didn't complete before the deadline
+         * reports `boost::asio::error::timed_out`.
+         * @return the number of bytes received.
+         */
+        virtual size_t read(boost::asio::mutable_buffer buffer, Clock::time_point deadline,
+                            boost::system::error_code &error) = 0;
+
+        /**
+         * Discard the buffered bytes of the transport.
+         * @param what determines the buffers to flush.
+         * @throws boost::system::system_error if any error.
+         */
+        virtual void flush(FlushType what) = 0;
+
+        /**
+         * Write the supplied bytes to the bus.
+         * @param data the bytes to be sent.
+         * @return the number of bytes written.
+         * @throws boost::system::system_error if any error.
+         */
+        size_t write(boost::asio::const_buffer data);
+
+        /**
+         * Write the supplied data to the bus.
+         * @param data to be sent through the transport.
+         * @return the number of characters written.
+         * @throws boost::system::system_error if any error.
+         */
+        size_t write(const std::vector<byte> &data);
+
+        /**
+         * Write several buffers to the bus as one gathered write.
+         * @param buffers the buffers to be sent, in order.
+         * @return the number of bytes written.
+         * @throws boost::system::system_error if any error.
+         */
+        size_t write(const std::vector<boost::asio::const_buffer> &buffers);
+
+        /**
+         * Fill the supplied buffer with bytes from the bus.
+         * @param buffer the buffer to be filled completely.
+         * @param deadline point in time after which the read is abandoned.
+         * @throws boost::system::system_error if any error, including a timeout.
+         */
+        void read(boost::asio::mutable_buffer buffer, Clock::time_point deadline);
+
+        /**
+         * Read a certain amount of data from the bus, waiting at most the configured timeout.
+         * @param size how much data to read.
+         * @return the receive buffer.
+         * @throws boost::system::system_error if any error, including a timeout.
+         */
+        std::vector<byte> read(size_t size);
+
+        /**
+         * Set the timeout on read operations without an explicit deadline.
+         * @param t duration for the timeout.
+         */
+        void setTimeout(const Clock::duration &t);
+
+        /**
+         * @return the timeout on read operations without an explicit deadline.
+         */
+        Clock::duration getTimeout() const;
+
+        /**
+         * The lock of the bus, to be held while sending a packet and receiving its reply. It's recursive, so a
+         * caller can hold it around several packets, e.g. `TransmitBatch::send()` and reading the replies. A
+         * wrapping transport has a lock of its own, so threads must share the same transport object.
+         * @return the mutex.
+         */
+        std::recursive_mutex &getBusMutex();
+
+    private:
+        Clock::duration timeout;
+        std::recursive_mutex busMutex;
+    };
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string>
 #include <vector>
 
 namespace goliath::dynamixel {
@@ -9,6 +10,15 @@ namespace goliath::dynamixel {
 
         static short convertFromHL(unsigned char hexL, unsigned char hexH);
 
-        static unsigned char checkSum(std::vector<unsigned char> data);
+        static unsigned char checkSum(const std::vector<unsigned char> &data);
+
+        /**
+         * @param data a packet, starting with the [0xFF, 0xFF] header.
+         * @param size the number of bytes to sum, without the checksum itself.
+         * @return the checksum of the bytes after the header.
+         */
+        static unsigned char checkSum(const unsigned char *data, size_t size);
+
+        static std::string toHexString(const unsigned char *data, size_t size);
     };
 }
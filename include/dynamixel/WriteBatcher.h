@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Dynamixel.h"
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace goliath::dynamixel {
+    /**
+     * Collects writes to the control tables of several Dynamixel units and sends those to the same range as one
+     * SYNC WRITE. Independent controllers can keep writing through their own `Dynamixel` object: once a batcher is
+     * set on it (see `Dynamixel::setWriteBatcher()`), its `queueWriteData()`, `queueSetGoalPosition()`,
+     * `queueSetMovingSpeed()` and `queueMoveTo()` writes are queued here instead of being sent one by one.
+     *
+     * The queued writes are sent when `flush()` is called, e.g. once per control tick, or, with a window, at the
+     * latest the window after the first write of a batch. SYNC WRITE is broadcast, so the units don't report
+     * errors; the future of a write only tells whether the packet went out. A unit written to twice in a batch
+     * gets the last value. Reads aren't batched and overtake queued writes.
+     */
+    class WriteBatcher {
+    public:
+        using byte = Dynamixel::byte;
+        using Clock = Transport::Clock;
+
+        /**
+         * @param port the transport to send the batches through. With a window, batches are sent from a thread of
+         * the batcher; every SYNC WRITE is sent under the bus lock of the transport (see `Transport::getBusMutex()`),
+         * so it never lands inside a transaction of a `Dynamixel` on the same transport.
+         * @param window how long after the first write a batch is sent by itself, or zero to send only on `flush()`.
+         */
+        explicit WriteBatcher(std::shared_ptr<Transport> port, Clock::duration window = Clock::duration::zero());
+
+        WriteBatcher(const WriteBatcher &) = delete;
+
+        WriteBatcher &operator=(const WriteBatcher &) = delete;
+
+        /**
+         * Send the writes that are still queued.
+         */
+        ~WriteBatcher();
+
+        /**
+         * Queue a write.
+         * @param id the ID of the Dynamixel unit.
+         * @param address the starting address of the location where the data is to be written.
+         * @param data the bytes to be written.
+         * @return a future that becomes ready once the batch is sent, holding the `boost::system::system_error`
+         * if it couldn't be.
+         * @throws std::invalid_argument if the data is empty or too long for a SYNC WRITE.
+         */
+        std::future<void> write(byte id, Dynamixel::Address address, const std::vector<byte> &data);
+
+        /**
+         * Send all queued writes, one SYNC WRITE per range.
+         * @return the number of packets sent.
+         */
+        size_t flush();
+
+        /**
+         * @return the number of queued writes.
+         */
+        size_t size() const;
+
+        Clock::duration getWindow() const;
+
+    private:
+        /**
+         * Queued writes to the same range.
+         */
+        struct Batch {
+            Dynamixel::Address address;
+            size_t length;
+            std::vector<byte> ids;
+            // `length` bytes per unit.
+            std::vector<byte> data;
+            std::vector<std::promise<void>> promises;
+        };
+
+        std::shared_ptr<Transport> port;
+        Clock::duration window;
+
+        mutable std::mutex mutex;
+        std::condition_variable changed;
+        std::vector<Batch> batches;
+        Clock::time_point deadline;
+        bool stopping = false;
+        std::thread thread;
+
+        // Serializes sending, so batches go out in order.
+        std::mutex sendMutex;
+
+        /**
+         * Send batches once their window has passed.
+         */
+        void run();
+
+        /**
+         * Send batches and complete their futures.
+         * @param batches the batches to send.
+         */
+        void send(std::vector<Batch> &batches);
+    };
+}
@@ -0,0 +1,71 @@
+#include "dynamixel/AllocationCounter.h"
+
+#include <atomic>
+
+using namespace goliath::dynamixel;
+
+namespace {
+    std::atomic<bool> installed{false};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> lockCount{0};
+
+    // Constant-initialized, so they're safe to use from `malloc` at any time.
+    thread_local bool watched = false;
+    thread_local bool trapped = false;
+    thread_local uint64_t threadCount = 0;
+    thread_local uint64_t threadLockCount = 0;
+}
+
+bool AllocationCounter::isInstalled() {
+    return installed.load(std::memory_order_relaxed);
+}
+
+void AllocationCounter::watch(bool watch, bool trap) {
+    watched = watch;
+    trapped = watch && trap;
+}
+
+uint64_t AllocationCounter::getCount() {
+    return count.load(std::memory_order_relaxed);
+}
+
+uint64_t AllocationCounter::getThreadCount() {
+    return threadCount;
+}
+
+uint64_t AllocationCounter::getLockCount() {
+    return lockCount.load(std::memory_order_relaxed);
+}
+
+uint64_t AllocationCounter::getThreadLockCount() {
+    return threadLockCount;
+}
+
+void AllocationCounter::record() noexcept {
+    if (!watched) {
+        return;
+    }
+
+    count.fetch_add(1, std::memory_order_relaxed);
+    ++threadCount;
+    if (trapped) {
+        std::abort();
+    }
+}
+
+void AllocationCounter::recordLock() noexcept {
+    if (!watched) {
+        return;
+    }
+
+    lockCount.fetch_add(1, std::memory_order_relaxed);
+    ++threadLockCount;
+    if (trapped) {
+        std::abort();
+    }
+}
+
+bool AllocationCounter::install() noexcept {
+    installed.store(true, std::memory_order_relaxed);
+    return true;
+}
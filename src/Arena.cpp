@@ -0,0 +1,18 @@
+#include "dynamixel/Arena.h"
+
+#include <cstring>
+
+using namespace goliath::dynamixel;
+
+Arena::Arena(size_t capacity) : memory(new unsigned char[capacity]), capacity(capacity) {
+    // Fault every page in now rather than in the first cycles.
+    std::memset(memory.get(), 0, capacity);
+}
+
+size_t Arena::size() const {
+    return used;
+}
+
+size_t Arena::getCapacity() const {
+    return capacity;
+}
@@ -0,0 +1,301 @@
+#include "dynamixel/AsyncDynamixel.h"
+
+#include <algorithm>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/log/trivial.hpp>
+
+using namespace goliath::dynamixel;
+
+using boost::asio::awaitable;
+using boost::asio::redirect_error;
+using boost::asio::use_awaitable;
+
+AsyncBus::AsyncBus(std::shared_ptr<SerialPort> port) : port(std::move(port)) {
+}
+
+std::shared_ptr<SerialPort> AsyncBus::getPort() const {
+    return port;
+}
+
+awaitable<AsyncBus::Lock> AsyncBus::lock() {
+    if (!busy) {
+        busy = true;
+        co_return Lock(this);
+    }
+
+    // Wait until `unlock()` hands the bus over by cancelling the timer.
+    Waiter waiter(port->getIoService());
+    waiter.timer.expires_at(SerialPort::TimerType::time_point::max());
+    waiting.push_back(&waiter);
+
+    // If the task is destroyed while it waits, leave the queue, or pass the bus on if it was handed over already.
+    struct Abandon {
+        AsyncBus *bus;
+        Waiter *waiter;
+        bool armed = true;
+
+        ~Abandon() {
+            if (!armed) {
+                return;
+            }
+
+            if (waiter->granted) {
+                bus->unlock();
+            } else {
+                bus->waiting.erase(std::find(bus->waiting.begin(), bus->waiting.end(), waiter));
+            }
+        }
+    } abandon{this, &waiter};
+
+    boost::system::error_code error;
+    co_await waiter.timer.async_wait(redirect_error(use_awaitable, error));
+
+    abandon.armed = false;
+    co_return Lock(this);
+}
+
+void AsyncBus::unlock() {
+    if (waiting.empty()) {
+        busy = false;
+        return;
+    }
+
+    Waiter *next = waiting.front();
+    waiting.pop_front();
+    next->granted = true;
+    next->timer.cancel();
+}
+
+awaitable<size_t> AsyncBus::read(boost::asio::mutable_buffer buffer, Transport::Clock::time_point deadline,
+                                  boost::system::error_code &error) {
+    // The timer handler may outlive this frame, so it only touches shared state.
+    auto completed = std::make_shared<bool>(false);
+    SerialPort::TimerType timer(port->getIoService());
+    timer.expires_at(deadline);
+    timer.async_wait([serialPort = port, completed](const boost::system::error_code &error) {
+        if (!error && !*completed) {
+            serialPort->getSerialPort().cancel();
+        }
+    });
+
+    size_t bytesReceived = co_await boost::asio::async_read(port->getSerialPort(), buffer,
+                                                            redirect_error(use_awaitable, error));
+    *completed = true;
+    timer.cancel();
+
+    if (error == boost::asio::error::operation_aborted && Transport::Clock::now() >= deadline) {
+        error = boost::asio::error::timed_out;
+    }
+
+    co_return bytesReceived;
+}
+
+awaitable<Result<std::vector<AsyncBus::byte>>> AsyncBus::transact(byte id, Dynamixel::Instruction instruction,
+                                                                  std::vector<byte> data, int tries) {
+    std::vector<byte> instructionPacket = Dynamixel::getInstructionPacket(id, instruction, data);
+    std::vector<byte> statusPacket;
+
+    Lock busLock = co_await lock();
+
+    boost::system::error_code error;
+    for (; tries >= 0; --tries) {
+        error = co_await transactOnce(id, instructionPacket, statusPacket);
+        if (!error) {
+            break;
+        }
+
+        if (tries > 0) {
+            BOOST_LOG_TRIVIAL(trace) << "Retrying " << tries << " " << error.message();
+        }
+    }
+
+    if (error) {
+        co_return Result<std::vector<byte>>(error);
+    }
+    byte errorCode = statusPacket[4];
+    co_return Result<std::vector<byte>>(std::move(statusPacket), errorCode);
+}
+
+awaitable<boost::system::error_code> AsyncBus::transactOnce(byte id, const std::vector<byte> &instructionPacket,
+                                                            std::vector<byte> &statusPacket) {
+    boost::system::error_code error;
+
+    try {
+        port->flush(Transport::FlushType::Receive);
+    } catch (const boost::system::system_error &e) {
+        co_return e.code();
+    }
+
+    co_await boost::asio::async_write(port->getSerialPort(), boost::asio::buffer(instructionPacket),
+                                      redirect_error(use_awaitable, error));
+    if (error) {
+        co_return error;
+    }
+
+    auto deadline = Transport::Clock::now() + port->getTimeout();
+
+    statusPacket.resize(5);
+    size_t received = co_await read(boost::asio::buffer(statusPacket), deadline, error);
+    if (error == boost::asio::error::timed_out) {
+        co_return received == 0 ? Errc::Timeout : Errc::IncompletePacket;
+    } else if (error) {
+        co_return error;
+    }
+
+    size_t length;
+    error = Dynamixel::checkStatusHeader(statusPacket, id, length);
+    if (error) {
+        co_return error;
+    }
+
+    statusPacket.resize(5 + length);
+    co_await read(boost::asio::buffer(statusPacket.data() + 5, length), deadline, error);
+    if (error == boost::asio::error::timed_out) {
+        co_return Errc::IncompletePacket;
+    } else if (error) {
+        co_return error;
+    }
+
+    co_return Dynamixel::checkStatusChecksum(statusPacket);
+}
+
+AsyncDynamixel::AsyncDynamixel(byte id, std::shared_ptr<AsyncBus> bus) : id(id),
+                                                                        bus(std::move(bus)),
+                                                                        errorMonitor(ErrorMonitor::getDefault()) {
+}
+
+void AsyncDynamixel::setErrorMonitor(std::shared_ptr<ErrorMonitor> monitor) {
+    errorMonitor = std::move(monitor);
+}
+
+AsyncDynamixel::byte AsyncDynamixel::getLastError() const {
+    return lastError;
+}
+
+int AsyncDynamixel::getId() const {
+    return id;
+}
+
+awaitable<Result<std::vector<AsyncDynamixel::byte>>> AsyncDynamixel::send(Dynamixel::Instruction instruction,
+                                                                           std::vector<byte> data) {
+    Result<std::vector<byte>> result = co_await bus->transact(id, instruction, std::move(data));
+    if (result) {
+        byte errorCode = result.servoError();
+        if (errorMonitor && (errorCode != 0 || lastError != 0)) {
+            errorMonitor->record(id, errorCode);
+        }
+        lastError = errorCode;
+    }
+
+    co_return result;
+}
+
+awaitable<Result<void>> AsyncDynamixel::ping() {
+    Result<std::vector<byte>> result = co_await send(Dynamixel::Instruction::Ping, std::vector<byte>());
+    co_return Result<void>(result.error(), result.servoError());
+}
+
+awaitable<Result<std::vector<AsyncDynamixel::byte>>> AsyncDynamixel::readBlock(Address address, size_t length) {
+    std::vector<byte> params = {static_cast<byte>(address), static_cast<byte>(length)};
+    Result<std::vector<byte>> result = co_await send(Dynamixel::Instruction::Read, std::move(params));
+    if (!result) {
+        co_return result;
+    }
+
+    std::vector<byte> statusPacket = std::move(result).value();
+    if (statusPacket.size() != 5 + length) {
+        co_return Result<std::vector<byte>>(Errc::UnexpectedLength, lastError);
+    }
+
+    co_return Result<std::vector<byte>>(std::vector<byte>(statusPacket.begin() + 5, statusPacket.end()),
+                                        lastError);
+}
+
+awaitable<Result<int>> AsyncDynamixel::readData(Address address, size_t length) {
+    Result<std::vector<byte>> result = co_await readBlock(address, length);
+    if (!result) {
+        co_return Result<int>(result.error(), result.servoError());
+    }
+
+    const std::vector<byte> &data = result.value();
+    if (data.size() == 2) {
+        co_return Result<int>(Utils::convertFromHL(data[0], data[1]), result.servoError());
+    }
+
+    co_return Result<int>(data[0], result.servoError());
+}
+
+awaitable<Result<void>> AsyncDynamixel::writeData(Address address, std::vector<byte> data) {
+    data.insert(data.begin(), static_cast<byte>(address));
+
+    Result<std::vector<byte>> result = co_await send(Dynamixel::Instruction::Write, std::move(data));
+    co_return Result<void>(result.error(), result.servoError());
+}
+
+awaitable<Result<int>> AsyncDynamixel::goalPosition() {
+    return readData(Address::GoalPosition, 2);
+}
+
+awaitable<Result<int>> AsyncDynamixel::movingSpeed() {
+    return readData(Address::MovingSpeed, 2);
+}
+
+awaitable<Result<int>> AsyncDynamixel::torqueLimit() {
+    return readData(Address::TorqueLimit, 2);
+}
+
+awaitable<Result<int>> AsyncDynamixel::presentPosition() {
+    return readData(Address::PresentPosition, 2);
+}
+
+awaitable<Result<int>> AsyncDynamixel::presentSpeed() {
+    return readData(Address::PresentSpeed, 2);
+}
+
+awaitable<Result<int>> AsyncDynamixel::presentLoad() {
+    Result<std::vector<byte>> result = co_await readBlock(Address::PresentLoad, 2);
+    if (!result) {
+        co_return Result<int>(result.error(), result.servoError());
+    }
+
+    const std::vector<byte> &data = result.value();
+    // Bit 10 is set for a clockwise load.
+    int loadDirection = (data[1] & (1u << 2u)) != 0u ? -1 : 1;
+    int absLoad = Utils::convertFromHL(data[0], static_cast<byte>(3u & data[1]));
+
+    co_return Result<int>(loadDirection * absLoad, result.servoError());
+}
+
+awaitable<Result<int>> AsyncDynamixel::presentVoltage() {
+    return readData(Address::PresentVoltage, 1);
+}
+
+awaitable<Result<int>> AsyncDynamixel::presentTemperature() {
+    return readData(Address::PresentTemperature, 1);
+}
+
+awaitable<Result<bool>> AsyncDynamixel::isMoving() {
+    Result<int> result = co_await readData(Address::Moving, 1);
+    if (!result) {
+        co_return Result<bool>(result.error(), result.servoError());
+    }
+
+    co_return Result<bool>(result.value() == 1, result.servoError());
+}
+
+awaitable<Result<void>> AsyncDynamixel::setGoalPosition(short position) {
+    return writeData(Address::GoalPosition, Utils::convertToHL(position));
+}
+
+awaitable<Result<void>> AsyncDynamixel::setMovingSpeed(short speed) {
+    return writeData(Address::MovingSpeed, Utils::convertToHL(speed));
+}
+
+awaitable<Result<void>> AsyncDynamixel::moveTo(short position, short speed) {
+    std::vector<byte> data = Utils::convertToHL(position);
+    std::vector<byte> speedData = Utils::convertToHL(speed);
+    data.insert(data.end(), speedData.begin(), speedData.end());
+
+    return writeData(Address::GoalPosition, std::move(data));
+}
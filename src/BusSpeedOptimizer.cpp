@@ -0,0 +1,143 @@
+#include "dynamixel/BusSpeedOptimizer.h"
+
+#include <cmath>
+#include <thread>
+
+using namespace goliath::dynamixel;
+
+namespace {
+    // Give the units some time to apply a new baud rate.
+    constexpr auto SettleTime = std::chrono::milliseconds(20);
+}
+
+BusSpeedOptimizer::BusSpeedOptimizer(std::shared_ptr<SerialPort> port) : port(std::move(port)) {
+}
+
+std::vector<std::shared_ptr<Dynamixel>> BusSpeedOptimizer::discover(byte firstId, byte lastId,
+                                                                    Clock::duration timeout) {
+    auto previousTimeout = port->getTimeout();
+    port->setTimeout(timeout);
+
+    std::vector<std::shared_ptr<Dynamixel>> servos;
+    for (unsigned int id = firstId; id <= lastId; ++id) {
+        auto servo = std::make_shared<Dynamixel>(static_cast<byte>(id), port);
+        if (servo->tryPing(0)) {
+            servos.push_back(servo);
+        }
+    }
+
+    port->setTimeout(previousTimeout);
+    return servos;
+}
+
+BusSpeedOptimizer::Report BusSpeedOptimizer::migrate(const std::vector<std::shared_ptr<Dynamixel>> &servos,
+                                                     unsigned int baudRate, int returnDelayTime, int pings) {
+    Report report;
+    report.baudRateBefore = port->getBaudRate();
+    report.baudRateAfter = report.baudRateBefore;
+
+    // Measure and remember the current settings; don't touch anything if a unit is missing.
+    std::vector<int> returnDelays;
+    for (const auto &servo : servos) {
+        ServoReport servoReport;
+        servoReport.id = static_cast<byte>(servo->getId());
+        servoReport.roundTripBefore = measureRoundTrip(*servo, pings);
+        report.servos.push_back(servoReport);
+
+        Result<int> returnDelay = servo->tryReadData(Dynamixel::Address::ReturnDelayTime, 1);
+        if (!returnDelay) {
+            report.error = "Dynamixel " + std::to_string(servo->getId()) + " doesn't answer: " +
+                           returnDelay.error().message();
+            return report;
+        }
+        returnDelays.push_back(returnDelay.value());
+    }
+
+    for (size_t i = 0; i < servos.size(); ++i) {
+        if (!servos[i]->trySetReturnDelayTime(returnDelayTime)) {
+            report.error = "Couldn't set the return delay time of Dynamixel " + std::to_string(servos[i]->getId());
+            rollBack(servos, returnDelays, false, report.baudRateBefore, report);
+            return report;
+        }
+    }
+
+    // A status packet would be sent at the new rate and can't be read, so the baud rate is broadcast.
+    broadcastBaudRate(servos, baudRate);
+
+    std::this_thread::sleep_for(SettleTime);
+    port->setBaudRate(baudRate);
+    port->flush(Transport::FlushType::Both);
+
+    bool verified = true;
+    for (size_t i = 0; i < servos.size(); ++i) {
+        report.servos[i].verified = static_cast<bool>(servos[i]->tryPing(2));
+        verified = verified && report.servos[i].verified;
+    }
+
+    if (!verified) {
+        report.error = "Not all units answer at " + std::to_string(baudRate) + " baud";
+        rollBack(servos, returnDelays, true, report.baudRateBefore, report);
+        return report;
+    }
+
+    for (size_t i = 0; i < servos.size(); ++i) {
+        report.servos[i].roundTripAfter = measureRoundTrip(*servos[i], pings);
+    }
+
+    report.success = true;
+    report.baudRateAfter = baudRate;
+    return report;
+}
+
+BusSpeedOptimizer::Clock::duration BusSpeedOptimizer::measureRoundTrip(Dynamixel &servo, int pings) {
+    Clock::duration total = Clock::duration::zero();
+    int answered = 0;
+
+    for (int i = 0; i < pings; ++i) {
+        auto start = Clock::now();
+        if (servo.tryPing(0)) {
+            total += Clock::now() - start;
+            ++answered;
+        }
+    }
+
+    return answered > 0 ? total / answered : Clock::duration::zero();
+}
+
+void BusSpeedOptimizer::broadcastBaudRate(const std::vector<std::shared_ptr<Dynamixel>> &servos,
+                                          unsigned int baudRate) {
+    // See `Dynamixel::trySetBaudRate()`.
+    auto value = static_cast<byte>(std::round(2000000.0 / baudRate) - 1);
+
+    Dynamixel broadcast(Dynamixel::BroadcastId, port);
+    if (!servos.empty()) {
+        broadcast.setDirectionCallback(servos.front()->getDirectionCallback());
+    }
+    broadcast.trySendWithoutReply(Dynamixel::Instruction::Write,
+                                  {static_cast<byte>(Dynamixel::Address::BaudRate), value}).value();
+}
+
+bool BusSpeedOptimizer::rollBack(const std::vector<std::shared_ptr<Dynamixel>> &servos,
+                                 const std::vector<int> &returnDelays, bool switched, unsigned int baudRate,
+                                 Report &report) {
+    if (switched) {
+        // Every unit that took the new baud rate hears this, including those that didn't answer.
+        broadcastBaudRate(servos, baudRate);
+
+        std::this_thread::sleep_for(SettleTime);
+        port->setBaudRate(baudRate);
+        port->flush(Transport::FlushType::Both);
+    }
+
+    bool restored = true;
+    for (size_t i = 0; i < servos.size(); ++i) {
+        restored = servos[i]->trySetReturnDelayTime(returnDelays[i]).ok() && restored;
+    }
+
+    report.rolledBack = restored;
+    if (!restored) {
+        report.error += "; rolling back failed, the bus may be split";
+    }
+
+    return restored;
+}
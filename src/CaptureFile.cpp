@@ -0,0 +1,194 @@
+#include "dynamixel/CaptureFile.h"
+
+#include <boost/system/system_error.hpp>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace goliath::dynamixel;
+
+namespace {
+    [[noreturn]] void throwSystemError(int fd) {
+        int error = errno;
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        throw boost::system::system_error(error, boost::system::system_category());
+    }
+
+    uint64_t toTimestamp(std::chrono::steady_clock::time_point time) {
+        return static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count());
+    }
+}
+
+CaptureWriter::CaptureWriter(const std::string &path, size_t capacity)
+        : mappedSize(sizeof(CaptureHeader) + capacity * sizeof(CaptureRecord)) {
+    if (capacity == 0) {
+        throw std::invalid_argument("A capture file needs at least one record");
+    }
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 || ::ftruncate(fd, static_cast<off_t>(mappedSize)) != 0) {
+        throwSystemError(fd);
+    }
+
+    void *mapping = ::mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        throwSystemError(fd);
+    }
+    ::close(fd);
+
+    header = new(mapping) CaptureHeader();
+    std::memcpy(header->magic, CaptureHeader::Magic, sizeof(header->magic));
+    header->version = CaptureHeader::CurrentVersion;
+    header->recordSize = sizeof(CaptureRecord);
+    header->capacity = capacity;
+    records = reinterpret_cast<CaptureRecord *>(header + 1);
+}
+
+CaptureWriter::~CaptureWriter() {
+    ::munmap(header, mappedSize);
+}
+
+void CaptureWriter::record(CaptureRecord::Direction direction, const byte *data, size_t size, bool failed) {
+    uint64_t timestamp = toTimestamp(std::chrono::steady_clock::now());
+    size_t count = std::max<size_t>(1, (size + CaptureRecord::PayloadSize - 1) / CaptureRecord::PayloadSize);
+
+    // Reserve consecutive records, so a packet is never interleaved with another one. The index of the first
+    // record is the sequence number, so sequence numbers follow the order of the ring.
+    uint64_t first = header->written.fetch_add(count, std::memory_order_relaxed);
+    auto sequence = static_cast<uint32_t>(first);
+    header->packets.fetch_add(1, std::memory_order_relaxed);
+
+    for (size_t i = 0; i < count; ++i) {
+        CaptureRecord &record = records[(first + i) % header->capacity];
+        size_t offset = i * CaptureRecord::PayloadSize;
+        size_t length = std::min(CaptureRecord::PayloadSize, size - offset);
+
+        // Readers skip the record until it's committed again.
+        record.commit.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        record.timestamp = timestamp;
+        record.sequence = sequence;
+        record.direction = direction;
+        record.flags = static_cast<uint8_t>((i + 1 < count ? CaptureRecord::Continued : 0) |
+                                            (failed ? CaptureRecord::Failed : 0));
+        record.length = static_cast<uint16_t>(length);
+        std::memcpy(record.payload, data + offset, length);
+
+        record.commit.store(static_cast<uint32_t>(first + i + 1), std::memory_order_release);
+    }
+}
+
+CaptureReader::CaptureReader(const std::string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    struct stat status{};
+    if (fd < 0 || ::fstat(fd, &status) != 0) {
+        throwSystemError(fd);
+    }
+
+    mappedSize = static_cast<size_t>(status.st_size);
+    if (mappedSize < sizeof(CaptureHeader)) {
+        ::close(fd);
+        throw std::runtime_error("Not a capture file: " + path);
+    }
+
+    void *mapping = ::mmap(nullptr, mappedSize, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        throwSystemError(fd);
+    }
+    ::close(fd);
+
+    header = static_cast<const CaptureHeader *>(mapping);
+    records = reinterpret_cast<const CaptureRecord *>(header + 1);
+
+    if (std::memcmp(header->magic, CaptureHeader::Magic, sizeof(header->magic)) != 0 ||
+        header->version != CaptureHeader::CurrentVersion || header->recordSize != sizeof(CaptureRecord) ||
+        sizeof(CaptureHeader) + header->capacity * sizeof(CaptureRecord) > mappedSize) {
+        ::munmap(mapping, mappedSize);
+        throw std::runtime_error("Unsupported capture file: " + path);
+    }
+}
+
+CaptureReader::~CaptureReader() {
+    ::munmap(const_cast<CaptureHeader *>(header), mappedSize);
+}
+
+size_t CaptureReader::size() const {
+    return static_cast<size_t>(std::min<uint64_t>(header->written.load(), header->capacity));
+}
+
+const CaptureRecord &CaptureReader::at(size_t index) const {
+    uint64_t written = header->written.load();
+    uint64_t oldest = written > header->capacity ? written - header->capacity : 0;
+
+    return records[(oldest + index) % header->capacity];
+}
+
+std::vector<CapturedPacket> CaptureReader::packets() const {
+    std::vector<CapturedPacket> packets;
+
+    // One snapshot per scan; records beyond it are left for the next one.
+    uint64_t written = header->written.load(std::memory_order_acquire);
+    uint64_t oldest = written > header->capacity ? written - header->capacity : 0;
+
+    // Whether the last packet still expects records.
+    bool open = false;
+    for (uint64_t index = oldest; index < written; ++index) {
+        const CaptureRecord &record = records[index % header->capacity];
+
+        // Copy the record, then check it wasn't (re)written meanwhile.
+        auto commit = static_cast<uint32_t>(index + 1);
+        bool committed = record.commit.load(std::memory_order_acquire) == commit;
+
+        uint64_t timestamp = record.timestamp;
+        uint32_t sequence = record.sequence;
+        CaptureRecord::Direction direction = record.direction;
+        uint8_t flags = record.flags;
+        auto length = std::min<size_t>(record.length, CaptureRecord::PayloadSize);
+        unsigned char payload[CaptureRecord::PayloadSize];
+        std::memcpy(payload, record.payload, length);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        committed = committed && record.commit.load(std::memory_order_relaxed) == commit;
+
+        if (!committed) {
+            if (open) {
+                packets.pop_back();
+                open = false;
+            }
+            continue;
+        }
+
+        if (sequence == static_cast<uint32_t>(index)) {
+            if (open) {
+                packets.pop_back();
+            }
+
+            CapturedPacket packet;
+            packet.timestamp = std::chrono::steady_clock::time_point(std::chrono::nanoseconds(timestamp));
+            packet.direction = direction;
+            packet.failed = (flags & CaptureRecord::Failed) != 0;
+            packets.push_back(std::move(packet));
+        } else if (!open) {
+            // Continues a packet whose start was overwritten.
+            continue;
+        }
+
+        auto &data = packets.back().data;
+        data.insert(data.end(), payload, payload + length);
+        open = (flags & CaptureRecord::Continued) != 0;
+    }
+
+    if (open) {
+        packets.pop_back();
+    }
+
+    return packets;
+}
@@ -0,0 +1,48 @@
+#include "dynamixel/CaptureTransport.h"
+
+using namespace goliath::dynamixel;
+
+CaptureTransport::CaptureTransport(std::shared_ptr<Transport> transport, std::shared_ptr<CaptureWriter> writer)
+        : transport(std::move(transport)), writer(std::move(writer)) {
+    setTimeout(this->transport->getTimeout());
+}
+
+size_t CaptureTransport::write(boost::asio::const_buffer data, boost::system::error_code &error) {
+    size_t written = transport->write(data, error);
+    writer->record(CaptureRecord::Direction::Transmit, static_cast<const byte *>(data.data()), written,
+                   static_cast<bool>(error));
+
+    return written;
+}
+
+size_t CaptureTransport::write(const std::vector<boost::asio::const_buffer> &buffers,
+                               boost::system::error_code &error) {
+    size_t written = transport->write(buffers, error);
+
+    // Record every buffer as a packet of its own, as far as it was written.
+    size_t remaining = written;
+    for (const auto &buffer : buffers) {
+        size_t size = std::min(remaining, buffer.size());
+        writer->record(CaptureRecord::Direction::Transmit, static_cast<const byte *>(buffer.data()), size,
+                       size < buffer.size());
+        remaining -= size;
+        if (remaining == 0 && size < buffer.size()) {
+            break;
+        }
+    }
+
+    return written;
+}
+
+size_t CaptureTransport::read(boost::asio::mutable_buffer buffer, Clock::time_point deadline,
+                              boost::system::error_code &error) {
+    size_t received = transport->read(buffer, deadline, error);
+    writer->record(CaptureRecord::Direction::Receive, static_cast<const byte *>(buffer.data()), received,
+                   static_cast<bool>(error));
+
+    return received;
+}
+
+void CaptureTransport::flush(FlushType what) {
+    transport->flush(what);
+}
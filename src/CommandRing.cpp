@@ -0,0 +1,195 @@
+#include "dynamixel/CommandRing.h"
+
+#include "dynamixel/SyncWrite.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+using namespace goliath::dynamixel;
+
+namespace {
+    size_t getRegionSize(size_t capacity) {
+        return sizeof(CommandRingHeader) + capacity * (sizeof(CommandCell) + sizeof(CommandAck));
+    }
+
+    // An (address, ID) pair as an index.
+    constexpr size_t SetpointKeys = 0x10000;
+
+    size_t getKey(uint8_t address, uint8_t id) {
+        return static_cast<size_t>(address) << 8u | id;
+    }
+
+    size_t checkCapacity(size_t capacity) {
+        if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+            throw std::invalid_argument("The capacity of a command ring must be a power of two");
+        }
+
+        return capacity;
+    }
+}
+
+CommandReceiver::CommandReceiver(const std::string &name, size_t capacity)
+        : memory(name, SharedMemory::Access::Create, getRegionSize(checkCapacity(capacity))) {
+    header = new(memory.data()) CommandRingHeader();
+    header->version = CommandRingHeader::CurrentVersion;
+    header->capacity = static_cast<uint32_t>(capacity);
+    cells = reinterpret_cast<CommandCell *>(header + 1);
+    acks = reinterpret_cast<CommandAck *>(cells + capacity);
+
+    // Cell `i` is free for the command with sequence number `i`.
+    for (size_t i = 0; i < capacity; ++i) {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    std::memcpy(header->magic, CommandRingHeader::Magic, sizeof(header->magic));
+    std::atomic_thread_fence(std::memory_order_release);
+
+    setpoints.reserve(capacity);
+    indices.assign(SetpointKeys, 0);
+}
+
+size_t CommandReceiver::apply(Transport &port, uint64_t tick) {
+    uint64_t mask = header->capacity - 1;
+    uint64_t first = header->dequeuePosition.load(std::memory_order_relaxed);
+    // Commands claimed after this are left for the next tick, so a busy producer can't keep the tick draining.
+    uint64_t last = header->enqueuePosition.load(std::memory_order_acquire);
+    uint64_t position = first;
+
+    setpoints.clear();
+    for (; position != last && position - first < header->capacity; ++position) {
+        CommandCell &cell = cells[position & mask];
+        if (cell.sequence.load(std::memory_order_acquire) != position + 1) {
+            break;
+        }
+
+        Setpoint setpoint{cell.address, cell.id, cell.value};
+        // Hand the cell back to the producers for the command one lap later.
+        cell.sequence.store(position + header->capacity, std::memory_order_release);
+
+        uint32_t &index = indices[getKey(setpoint.address, setpoint.id)];
+        if (index != 0) {
+            setpoints[index - 1].value = setpoint.value;
+        } else {
+            setpoints.push_back(setpoint);
+            index = static_cast<uint32_t>(setpoints.size());
+        }
+    }
+
+    // Only the entries of this tick were set, so resetting those clears the index.
+    for (const Setpoint &setpoint : setpoints) {
+        indices[getKey(setpoint.address, setpoint.id)] = 0;
+    }
+
+    if (position == first) {
+        return 0;
+    }
+
+    // Commands of the same address end up next to each other, in the order the units were first commanded.
+    std::stable_sort(setpoints.begin(), setpoints.end(), [](const Setpoint &a, const Setpoint &b) {
+        return a.address < b.address;
+    });
+
+    try {
+        for (auto begin = setpoints.begin(); begin != setpoints.end();) {
+            // One packet per address, unless there are more units than a packet takes.
+            auto end = std::find_if(begin, setpoints.end(), [&](const Setpoint &setpoint) {
+                return setpoint.address != begin->address;
+            });
+            end = begin + static_cast<std::ptrdiff_t>(
+                    std::min<size_t>(static_cast<size_t>(end - begin), SyncWrite::getMaxUnits(2)));
+
+            SyncWrite syncWrite(static_cast<Dynamixel::Address>(begin->address), 2);
+            for (auto setpoint = begin; setpoint != end; ++setpoint) {
+                syncWrite.add(setpoint->id, setpoint->value);
+            }
+            syncWrite.send(port);
+
+            begin = end;
+        }
+    } catch (...) {
+        acknowledge(first, position, FailedTick);
+        throw;
+    }
+
+    acknowledge(first, position, tick);
+    return position - first;
+}
+
+void CommandReceiver::acknowledge(uint64_t first, uint64_t last, uint64_t tick) {
+    uint64_t mask = header->capacity - 1;
+    for (uint64_t sequence = first; sequence < last; ++sequence) {
+        CommandAck &ack = acks[sequence & mask];
+        // Invalidate the slot while its tick is rewritten, like a sequence lock.
+        ack.sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        ack.tick = tick;
+        ack.sequence.store(sequence + 1, std::memory_order_release);
+    }
+
+    if (tick != FailedTick) {
+        header->lastTick.store(tick, std::memory_order_relaxed);
+    }
+    header->dequeuePosition.store(last, std::memory_order_release);
+}
+
+CommandSender::CommandSender(const std::string &name) : memory(name, SharedMemory::Access::ReadWrite) {
+    header = static_cast<CommandRingHeader *>(memory.data());
+
+    if (memory.size() < sizeof(CommandRingHeader) ||
+        std::memcmp(header->magic, CommandRingHeader::Magic, sizeof(header->magic)) != 0 ||
+        header->version != CommandRingHeader::CurrentVersion || header->capacity == 0 ||
+        (header->capacity & (header->capacity - 1)) != 0 || getRegionSize(header->capacity) > memory.size()) {
+        throw std::runtime_error("Unsupported command ring: " + name);
+    }
+
+    cells = reinterpret_cast<CommandCell *>(header + 1);
+    acks = reinterpret_cast<const CommandAck *>(cells + header->capacity);
+}
+
+bool CommandSender::push(byte id, Dynamixel::Address address, uint16_t value, uint64_t &sequence) {
+    uint64_t mask = header->capacity - 1;
+    uint64_t position = header->enqueuePosition.load(std::memory_order_relaxed);
+
+    // Claim the cell of the next sequence number, unless another sender was faster or the ring is full.
+    CommandCell *cell;
+    for (;;) {
+        cell = &cells[position & mask];
+        auto difference = static_cast<int64_t>(cell->sequence.load(std::memory_order_acquire) - position);
+        if (difference == 0) {
+            if (header->enqueuePosition.compare_exchange_weak(position, position + 1,
+                                                              std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            return false;
+        } else {
+            position = header->enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->id = id;
+    cell->address = static_cast<uint8_t>(address);
+    cell->value = value;
+    cell->sequence.store(position + 1, std::memory_order_release);
+
+    sequence = position;
+    return true;
+}
+
+bool CommandSender::isAcknowledged(uint64_t sequence, uint64_t &tick) const {
+    const CommandAck &ack = acks[sequence & (header->capacity - 1)];
+    if (ack.sequence.load(std::memory_order_acquire) != sequence + 1) {
+        return false;
+    }
+
+    tick = ack.tick;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return ack.sequence.load(std::memory_order_relaxed) == sequence + 1;
+}
+
+uint64_t CommandSender::getAcknowledged() const {
+    return header->dequeuePosition.load(std::memory_order_acquire);
+}
+
+uint64_t CommandSender::getLastTick() const {
+    return header->lastTick.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,103 @@
+#include "dynamixel/Conversion.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace goliath::dynamixel;
+
+namespace {
+    // Bit 10 of speed and load values is set for the clockwise direction.
+    constexpr uint16_t DirectionBit = 1u << 10u;
+    constexpr uint16_t MagnitudeMask = DirectionBit - 1u;
+
+    inline float signOf(uint16_t raw) {
+        return (raw & DirectionBit) != 0u ? -1.0f : 1.0f;
+    }
+
+    inline uint16_t roundToRaw(float value, float max) {
+        return static_cast<uint16_t>(std::min(std::max(value, 0.0f), max) + 0.5f);
+    }
+}
+
+void Conversion::positionToRadians(const uint16_t *__restrict raw, const float *__restrict offset,
+                                   const float *__restrict direction, float *__restrict radians, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        radians[i] = direction[i] * (static_cast<float>(raw[i]) - CenterPosition) * RadiansPerTick + offset[i];
+    }
+}
+
+void Conversion::radiansToPosition(const float *__restrict radians, const float *__restrict offset,
+                                   const float *__restrict direction, uint16_t *__restrict raw, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        float ticks = direction[i] * (radians[i] - offset[i]) / RadiansPerTick + CenterPosition;
+        raw[i] = roundToRaw(ticks, MaxPosition);
+    }
+}
+
+void Conversion::speedToRadiansPerSecond(const uint16_t *__restrict raw, const float *__restrict direction,
+                                         float *__restrict velocity, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        velocity[i] = direction[i] * signOf(raw[i]) * static_cast<float>(raw[i] & MagnitudeMask) *
+                      RadiansPerSecondPerSpeedUnit;
+    }
+}
+
+void Conversion::radiansPerSecondToSpeed(const float *__restrict velocity, uint16_t *__restrict raw, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        float units = std::max(std::abs(velocity[i]) / RadiansPerSecondPerSpeedUnit, 1.0f);
+        raw[i] = roundToRaw(units, MaxSpeed);
+    }
+}
+
+void Conversion::loadToEffort(const uint16_t *__restrict raw, const float *__restrict direction,
+                              float *__restrict effort, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        effort[i] = direction[i] * signOf(raw[i]) * static_cast<float>(raw[i] & MagnitudeMask) * EffortPerLoadUnit;
+    }
+}
+
+void Conversion::effortToTorqueLimit(const float *__restrict effort, uint16_t *__restrict raw, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        raw[i] = roundToRaw(effort[i] / EffortPerLoadUnit, MaxTorque);
+    }
+}
+
+void Conversion::voltageToVolts(const uint8_t *__restrict raw, float *__restrict volts, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        volts[i] = static_cast<float>(raw[i]) * VoltsPerVoltageUnit;
+    }
+}
+
+void Conversion::voltsToVoltage(const float *__restrict volts, uint8_t *__restrict raw, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        raw[i] = static_cast<uint8_t>(roundToRaw(volts[i] / VoltsPerVoltageUnit, 255.0f));
+    }
+}
+
+void Conversion::temperatureToCelsius(const uint8_t *__restrict raw, float *__restrict celsius, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        celsius[i] = static_cast<float>(raw[i]);
+    }
+}
+
+void Conversion::celsiusToTemperature(const float *__restrict celsius, uint8_t *__restrict raw, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        raw[i] = static_cast<uint8_t>(roundToRaw(celsius[i], 255.0f));
+    }
+}
+
+void Conversion::toJointState(const RawState &raw, const Calibration &calibration, JointState &joints) {
+    size_t size = raw.size();
+    if (calibration.offset.size() != size || calibration.direction.size() != size) {
+        throw std::invalid_argument("The calibration must have one entry per joint");
+    }
+    joints.resize(size);
+
+    positionToRadians(raw.position.data(), calibration.offset.data(), calibration.direction.data(),
+                      joints.position.data(), size);
+    speedToRadiansPerSecond(raw.speed.data(), calibration.direction.data(), joints.velocity.data(), size);
+    loadToEffort(raw.load.data(), calibration.direction.data(), joints.effort.data(), size);
+    voltageToVolts(raw.voltage.data(), joints.voltage.data(), size);
+    temperatureToCelsius(raw.temperature.data(), joints.temperature.data(), size);
+}
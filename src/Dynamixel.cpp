@@ -1,27 +1,117 @@
 #include "dynamixel/Dynamixel.h"
 
+#include "dynamixel/WriteBatcher.h"
+#include <boost/asio/error.hpp>
+#include <boost/log/trivial.hpp>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
 using namespace goliath::dynamixel;
 
-Dynamixel::Dynamixel(byte id, std::shared_ptr<SerialPort> port) : id(id),
-                                                                  port(std::move(port)) {
+Dynamixel::Dynamixel(byte id, std::shared_ptr<Transport> port) : id(id),
+                                                                  port(std::move(port)),
+                                                                  errorMonitor(ErrorMonitor::getDefault()) {
 }
 
 void Dynamixel::setDirectionCallback(std::function<void(bool)> callback) {
     this->callback = std::move(callback);
 }
 
+const std::function<void(bool)> &Dynamixel::getDirectionCallback() const {
+    return callback;
+}
+
+void Dynamixel::setErrorMonitor(std::shared_ptr<ErrorMonitor> monitor) {
+    errorMonitor = std::move(monitor);
+}
+
+std::shared_ptr<ErrorMonitor> Dynamixel::getErrorMonitor() const {
+    return errorMonitor;
+}
+
+void Dynamixel::setWriteBatcher(std::shared_ptr<WriteBatcher> batcher) {
+    writeBatcher = std::move(batcher);
+}
+
+std::shared_ptr<WriteBatcher> Dynamixel::getWriteBatcher() const {
+    return writeBatcher;
+}
+
+Dynamixel::byte Dynamixel::getLastError() const {
+    return lastError;
+}
+
+Dynamixel::Timing Dynamixel::getLastTiming() const {
+    return lastTiming;
+}
+
+bool Dynamixel::hasError(Error error) const {
+    return (lastError & static_cast<byte>(error)) != 0u;
+}
+
 std::vector<Dynamixel::byte> Dynamixel::send(Instruction instruction, const std::vector<byte> &data, int tries) {
+    Result<std::vector<byte>> result = trySend(instruction, data, tries);
+    if (!result) {
+        throw boost::system::system_error(result.error());
+    }
+
+    return std::move(result).value();
+}
+
+Result<std::vector<Dynamixel::byte>> Dynamixel::trySend(Instruction instruction, const std::vector<byte> &data,
+                                                        int tries) {
     // The structure of the instruction packet is as the following:
     // +----+----+--+------+-----------+----------+---+-----------+---------+
     // |0xFF|0xFF|ID|LENGTH|INSTRUCTION|PARAMETER1|...|PARAMETER N|CHECK SUM|
     // +----+----+--+------+-----------+----------+---+-----------+---------+
+    return trySendPacket(getInstructionPacket(instruction, data), tries);
+}
+
+Result<std::vector<Dynamixel::byte>> Dynamixel::trySendPacket(const std::vector<byte> &instructionPacket, int tries) {
+    std::vector<byte> statusPacket;
+
+    boost::system::error_code error;
+    for (; tries >= 0; --tries) {
+        error = transact(instructionPacket, statusPacket);
+        if (!error) {
+            return {std::move(statusPacket), lastError};
+        }
+
+        if (tries > 0) {
+            BOOST_LOG_TRIVIAL(trace) << "Retrying " << tries << " " << error.message();
+        }
+    }
+
+    // No status packet was parsed, so there are no error bits to report.
+    return {error, 0};
+}
+
+Result<void> Dynamixel::trySendWithoutReply(Instruction instruction, const std::vector<byte> &data) {
     std::vector<byte> instructionPacket = getInstructionPacket(instruction, data);
 
+    std::lock_guard<std::recursive_mutex> lock(port->getBusMutex());
+    Transport::Clock::time_point transmitStart;
+    return {writePacket(instructionPacket, transmitStart), 0};
+}
+
+boost::system::error_code Dynamixel::writePacket(const std::vector<byte> &instructionPacket,
+                                                 Transport::Clock::time_point &transmitStart) {
+    boost::system::error_code error;
+
+    try {
+        port->flush(Transport::FlushType::Receive);
+    } catch (const boost::system::system_error &e) {
+        return e.code();
+    }
+
     if (callback) {
         callback(true);
     }
 
-    port->write(instructionPacket);
+    transmitStart = Transport::Clock::now();
+    port->write(boost::asio::buffer(instructionPacket), error);
 
     if (callback) {
         std::this_thread::sleep_for(std::chrono::microseconds(22));
@@ -29,109 +119,117 @@ std::vector<Dynamixel::byte> Dynamixel::send(Instruction instruction, const std:
         std::this_thread::sleep_for(std::chrono::microseconds(readDelay));
     }
 
+    return error;
+}
+
+boost::system::error_code Dynamixel::transact(const std::vector<byte> &instructionPacket,
+                                              std::vector<byte> &statusPacket) {
+    // Other threads on the bus mustn't send anything before the status packet is received.
+    std::lock_guard<std::recursive_mutex> lock(port->getBusMutex());
+
+    Transport::Clock::time_point transmitStart;
+    boost::system::error_code error = writePacket(instructionPacket, transmitStart);
+    if (error) {
+        return error;
+    }
+
     // The structure of the status packet is as the following:
     // +----+----+--+------+-----+----------+---+-----------+---------+
     // |0xFF|0xFF|ID|LENGTH|ERROR|PARAMETER1|...|PARAMETER N|CHECK SUM|
     // +----+----+--+------+-----+----------+---+-----------+---------+
-    std::vector<byte> statusPacket;
-    try {
-        statusPacket = port->read(5); // [0xFF, 0xFF, id, length, error]
-    } catch (std::exception &ex) {
-        if (tries > 0) {
-            BOOST_LOG_TRIVIAL(trace) << "Retrying " << tries << " " << ex.what();
-            return send(instruction, data, tries - 1);
-        }
-        throw ex;
+    auto deadline = Transport::Clock::now() + port->getTimeout();
+
+    statusPacket.resize(5);
+    size_t received = port->read(boost::asio::buffer(statusPacket), deadline, error); // [0xFF, 0xFF, id, length, error]
+    if (error == boost::asio::error::timed_out) {
+        return received == 0 ? Errc::Timeout : Errc::IncompletePacket;
+    } else if (error) {
+        return error;
     }
 
-    // Assert the packet is a sequence with 5 items.
-    if (statusPacket.size() < 5) {
-        std::string error =
-                "Incomplete packet. Received " + std::to_string(statusPacket.size()) + " instead of expected 5 bytes.";
-        if (tries > 0) {
-            BOOST_LOG_TRIVIAL(trace) << "Retrying " << tries << " " << error;
-            return send(instruction, data, tries - 1);
-        }
-        throw std::runtime_error(error);
+    size_t length;
+    error = checkStatusHeader(statusPacket, id, length);
+    if (error) {
+        return error;
     }
 
-    // Check the header bytes.
-    if (statusPacket[0] != '\xFF' || statusPacket[1] != '\xFF') {
-        std::string error = (boost::format("Wrong header; should be equal to [0xFF, 0xFF] received [0x%02X, 0x%02X]")
-                             % static_cast<int>(statusPacket[0])
-                             % static_cast<int>(statusPacket[1])).str();
-        if (tries > 0) {
-            BOOST_LOG_TRIVIAL(trace) << "Retrying " << tries << " " << error;
-            return send(instruction, data, tries - 1);
-        }
-        throw std::runtime_error(error);
+    statusPacket.resize(5 + length);
+    port->read(boost::asio::buffer(statusPacket.data() + 5, length), deadline, error); // [parameter1, ..., checksum]
+    if (error == boost::asio::error::timed_out) {
+        return Errc::IncompletePacket;
+    } else if (error) {
+        return error;
     }
 
-    if (statusPacket[2] != id) {
-        std::string error = "Received wrong id " + std::to_string(statusPacket[2]) + " expected " + std::to_string(id);
-        if (tries > 0) {
-            BOOST_LOG_TRIVIAL(trace) << "Retrying " << tries << " " << error;
-            return send(instruction, data, tries - 1);
-        }
-        throw std::runtime_error(error);
+    auto receiveComplete = Transport::Clock::now();
+    error = checkStatusChecksum(statusPacket);
+    if (error) {
+        return error;
     }
+    lastTiming = {transmitStart, receiveComplete};
 
-    byte length = static_cast<byte>(std::min(statusPacket[3] - 1, 3));
-    byte errorCode = statusPacket[4];
+    // Check the error code; the parameters that follow are still valid.
+    checkError(statusPacket[4]);
 
-    if (errorCode != 0) {
-        // Check the error code, if there's one.
-        checkError(errorCode);
+    return {};
+}
 
-        // Return early with the status packet so far; no need to read further.
-        return statusPacket;
-    }
+boost::system::error_code Dynamixel::checkStatusHeader(const std::vector<byte> &statusPacket, byte id,
+                                                       size_t &length) {
+    return checkStatusHeader(statusPacket.data(), id, length);
+}
 
-    std::vector<byte> statusPacketEnd;
-    try {
-        statusPacketEnd = port->read(length);  // [parameter1, ..., checksum]
-    } catch (std::exception &ex) {
-        if (tries > 0) {
-            BOOST_LOG_TRIVIAL(trace) << "Retrying " << tries << " " << ex.what();
-            return send(instruction, data, tries - 1);
-        }
-        throw ex;
+boost::system::error_code Dynamixel::checkStatusHeader(const byte *statusPacket, byte id, size_t &length) {
+    // Check the header bytes.
+    if (statusPacket[0] != 0xFF || statusPacket[1] != 0xFF) {
+        return Errc::WrongHeader;
     }
 
-    byte checkSum = statusPacketEnd[statusPacketEnd.size() - 1];
-    statusPacketEnd.pop_back();
+    if (statusPacket[2] != id) {
+        return Errc::WrongId;
+    }
 
-    if (statusPacketEnd.size() != length - 1u) {
-        std::string error =
-                "Incomplete second packet. Received " + std::to_string(statusPacket.size()) + " instead of expected " +
-                std::to_string(length) + " bytes";
-        if (tries > 0) {
-            BOOST_LOG_TRIVIAL(trace) << "Retrying " << tries << " " << error;
-            return send(instruction, data, tries - 1);
-        }
-        throw std::runtime_error(error);
+    // The length covers the error byte, the parameters and the checksum.
+    if (statusPacket[3] < 2) {
+        return Errc::IncompletePacket;
     }
-    statusPacket.insert(statusPacket.end(), statusPacketEnd.begin(), statusPacketEnd.end());
+    length = statusPacket[3] - 1u;
 
-    if (Utils::checkSum(statusPacket) != checkSum) {
-        std::string error = "Invalid checksum";
-        if (tries > 0) {
-            BOOST_LOG_TRIVIAL(trace) << "Retrying " << tries << " " << error;
-            return send(instruction, data, tries - 1);
-        }
-        throw std::runtime_error(error);
+    return {};
+}
+
+boost::system::error_code Dynamixel::checkStatusChecksum(std::vector<byte> &statusPacket) {
+    boost::system::error_code error = checkStatusChecksum(statusPacket.data(), statusPacket.size());
+    statusPacket.pop_back();
+
+    return error;
+}
+
+boost::system::error_code Dynamixel::checkStatusChecksum(const byte *statusPacket, size_t size) {
+    if (Utils::checkSum(statusPacket, size - 1) != statusPacket[size - 1]) {
+        return Errc::InvalidChecksum;
     }
 
-    return statusPacket;
+    return {};
 }
 
 std::vector<Dynamixel::byte> Dynamixel::getInstructionPacket(Instruction instruction, const std::vector<byte> &data) {
-    std::vector<byte> instructionPacket;
+    return getInstructionPacket(id, instruction, data);
+}
 
+std::vector<Dynamixel::byte> Dynamixel::getInstructionPacket(byte id, Instruction instruction,
+                                                             const std::vector<byte> &data) {
     size_t numberOfParameters = data.size();
+    if (numberOfParameters > MaxParameters) {
+        throw std::invalid_argument("An instruction packet carries at most " + std::to_string(MaxParameters) +
+                                    " parameters");
+    }
 
-    instructionPacket.push_back('\xFF');
-    instructionPacket.push_back('\xFF');
+    std::vector<byte> instructionPacket;
+    instructionPacket.reserve(data.size() + 6);
+
+    instructionPacket.push_back(0xFF);
+    instructionPacket.push_back(0xFF);
     instructionPacket.push_back(id);
 
     // bodyLength
@@ -153,52 +251,80 @@ std::vector<Dynamixel::byte> Dynamixel::getInstructionPacket(Instruction instruc
 }
 
 void Dynamixel::checkError(byte errorCode) {
-    if ((errorCode & static_cast<byte>(Error::Instruction)) != 0u) { // Instruction error
-        BOOST_LOG_TRIVIAL(warning) << "Instruction error: a undefined instruction is transmitted.";
-    }
-    if ((errorCode & static_cast<byte>(Error::Overload)) != 0u) { // Overload error
-        BOOST_LOG_TRIVIAL(warning)
-            << "Overload error: the current load cannot be controlled with the set maximum torque.";
-    }
-    if ((errorCode & static_cast<byte>(Error::Checksum)) != 0u) { // Checksum error
-        BOOST_LOG_TRIVIAL(warning) << "Checksum error: the checksum of the transmitted instruction packet is invalid.";
-    }
-    if ((errorCode & static_cast<byte>(Error::Range)) != 0u) { // Range error
-        BOOST_LOG_TRIVIAL(warning) << "Range error: given command is beyond the range of usage.";
-    }
-    if ((errorCode & static_cast<byte>(Error::Overheat)) != 0u) { // Overheating error
-        BOOST_LOG_TRIVIAL(warning) << "Overheating error: internal temperature is out of the range.";
-    }
-    if ((errorCode & static_cast<byte>(Error::AngleLimit)) != 0u) { // Angle limit error
-        BOOST_LOG_TRIVIAL(warning) << "Angle limit error: goal position is not between CW angle limit and CCW.";
-    }
-    if ((errorCode & static_cast<byte>(Error::InputVoltage)) != 0u) { // Input voltage error
-        BOOST_LOG_TRIVIAL(warning) << "Input voltage error: applied voltage is out of the range.";
+    // Only changes and errors are reported, the common error-free path stays lock free.
+    if (errorMonitor && (errorCode != 0 || lastError != 0)) {
+        errorMonitor->record(id, errorCode);
     }
+    lastError = errorCode;
 }
 
 int Dynamixel::readData(Address address, size_t length) {
+    Result<int> result = tryReadData(address, length);
+    if (!result && result.error() != Errc::UnexpectedLength) {
+        throw boost::system::system_error(result.error());
+    }
+
+    return result.valueOr(-1);
+}
+
+Result<std::vector<Dynamixel::byte>> Dynamixel::tryReadBlock(Address address, size_t length, int tries) {
     std::vector<byte> params = {static_cast<byte>(address), static_cast<byte>(length)};
-    std::vector<byte> statusPacket = send(Instruction::Read, params);
+    Result<std::vector<byte>> result = trySend(Instruction::Read, params, tries);
+    if (!result) {
+        return result;
+    }
+
+    std::vector<byte> statusPacket = std::move(result).value();
     std::vector<byte> data = cleanStatusPacket(statusPacket);
 
     // Assert that the packet is the correct size.
     if (data.size() != length) {
-        return -1;
+        return {Errc::UnexpectedLength, lastError};
+    }
+
+    return {std::move(data), lastError};
+}
+
+Result<int> Dynamixel::tryReadData(Address address, size_t length) {
+    Result<std::vector<byte>> result = tryReadBlock(address, length);
+    if (!result) {
+        return {result.error(), result.servoError()};
     }
 
+    const std::vector<byte> &data = result.value();
     if (data.size() == 2) {
-        return Utils::convertFromHL(data[0], data[1]);
+        return {Utils::convertFromHL(data[0], data[1]), result.servoError()};
     }
 
-    return data[0];
+    return {data[0], result.servoError()};
 }
 
 void Dynamixel::writeData(Address address, const std::vector<byte> &data) {
+    tryWriteData(address, data).value();
+}
+
+Result<void> Dynamixel::tryWriteData(Address address, const std::vector<byte> &data) {
     std::vector<byte> params = {static_cast<byte>(address)};
     params.insert(params.end(), data.begin(), data.end());
 
-    send(Instruction::Write, params);
+    Result<std::vector<byte>> result = trySend(Instruction::Write, params);
+    return {result.error(), result.servoError()};
+}
+
+std::future<void> Dynamixel::queueWriteData(Address address, const std::vector<byte> &data) {
+    if (writeBatcher) {
+        return writeBatcher->write(id, address, data);
+    }
+
+    std::promise<void> written;
+    try {
+        tryWriteData(address, data).value();
+        written.set_value();
+    } catch (...) {
+        written.set_exception(std::current_exception());
+    }
+
+    return written.get_future();
 }
 
 std::vector<Dynamixel::byte> Dynamixel::cleanStatusPacket(std::vector<byte> &statusPacket) {
@@ -214,10 +340,19 @@ bool Dynamixel::ping() {
     return statusPacket[2] == id;
 }
 
+Result<void> Dynamixel::tryPing(int tries) {
+    Result<std::vector<byte>> result = trySend(Instruction::Ping, {}, tries);
+    return {result.error(), result.servoError()};
+}
+
 int Dynamixel::getFirmwareVersion() {
     return readData(Address::FirmwareVersion, 1);
 }
 
+Result<int> Dynamixel::tryGetFirmwareVersion() {
+    return tryReadData(Address::FirmwareVersion, 1);
+}
+
 unsigned int Dynamixel::getBaudRate() {
     int value = readData(Address::BaudRate, 1);
 
@@ -228,6 +363,15 @@ unsigned int Dynamixel::getBaudRate() {
     return static_cast<unsigned int>(2000000 / (value + 1));
 }
 
+Result<unsigned int> Dynamixel::tryGetBaudRate() {
+    Result<int> result = tryReadData(Address::BaudRate, 1);
+    if (!result) {
+        return {result.error(), result.servoError()};
+    }
+
+    return {static_cast<unsigned int>(2000000 / (result.value() + 1)), result.servoError()};
+}
+
 int Dynamixel::getReturnDelayTime() {
     int value = readData(Address::ReturnDelayTime, 1);
 
@@ -238,42 +382,82 @@ int Dynamixel::getReturnDelayTime() {
     return value;
 }
 
+Result<int> Dynamixel::tryGetReturnDelayTime() {
+    return tryReadData(Address::ReturnDelayTime, 1);
+}
+
 int Dynamixel::getCWAngleLimit() {
     return readData(Address::CWAngleLimit, 2);
 }
 
+Result<int> Dynamixel::tryGetCWAngleLimit() {
+    return tryReadData(Address::CWAngleLimit, 2);
+}
+
 int Dynamixel::getCCWAngleLimit() {
     return readData(Address::CCWAngleLimit, 2);
 }
 
+Result<int> Dynamixel::tryGetCCWAngleLimit() {
+    return tryReadData(Address::CCWAngleLimit, 2);
+}
+
 int Dynamixel::getMaxTemperature() {
     return readData(Address::HighestLimitTemperature, 1);
 }
 
+Result<int> Dynamixel::tryGetMaxTemperature() {
+    return tryReadData(Address::HighestLimitTemperature, 1);
+}
+
 int Dynamixel::getMinVoltage() {
     return readData(Address::LowestLimitVoltage, 1);
 }
 
+Result<int> Dynamixel::tryGetMinVoltage() {
+    return tryReadData(Address::LowestLimitVoltage, 1);
+}
+
 int Dynamixel::getMaxVoltage() {
     return readData(Address::HighestLimitVoltage, 1);
 }
 
+Result<int> Dynamixel::tryGetMaxVoltage() {
+    return tryReadData(Address::HighestLimitVoltage, 1);
+}
+
 int Dynamixel::getMaxTorque() {
     return readData(Address::MaxTorque, 2);
 }
 
+Result<int> Dynamixel::tryGetMaxTorque() {
+    return tryReadData(Address::MaxTorque, 2);
+}
+
 int Dynamixel::getStatusReturnLevel() {
     return readData(Address::StatusReturnLevel, 1);
 }
 
+Result<int> Dynamixel::tryGetStatusReturnLevel() {
+    return tryReadData(Address::StatusReturnLevel, 1);
+}
+
 int Dynamixel::getDownCalibration() {
     return readData(Address::DownCalibration, 2);
 }
 
+Result<int> Dynamixel::tryGetDownCalibration() {
+    return tryReadData(Address::DownCalibration, 2);
+}
+
 int Dynamixel::getUpCalibration() {
     return readData(Address::UpCalibration, 2);
 }
 
+Result<int> Dynamixel::tryGetUpCalibration() {
+    return tryReadData(Address::UpCalibration, 2);
+}
+
 bool Dynamixel::isTorqueEnabled() {
     return readData(Address::TorqueStatus, 1) == 1;
 }
@@ -302,53 +486,97 @@ int Dynamixel::getGoalPosition() {
     return readData(Address::GoalPosition, 2);
 }
 
+Result<int> Dynamixel::tryGetGoalPosition() {
+    return tryReadData(Address::GoalPosition, 2);
+}
+
 int Dynamixel::getMovingSpeed() {
     return readData(Address::MovingSpeed, 2);
 }
 
+Result<int> Dynamixel::tryGetMovingSpeed() {
+    return tryReadData(Address::MovingSpeed, 2);
+}
+
 int Dynamixel::getTorqueLimit() {
     return readData(Address::TorqueLimit, 2);
 }
 
+Result<int> Dynamixel::tryGetTorqueLimit() {
+    return tryReadData(Address::TorqueLimit, 2);
+}
+
 int Dynamixel::getPresentPosition() {
     return readData(Address::PresentPosition, 2);
 }
 
+Result<int> Dynamixel::tryGetPresentPosition() {
+    return tryReadData(Address::PresentPosition, 2);
+}
+
 int Dynamixel::getPresentSpeed() {
     return readData(Address::PresentSpeed, 2);
 }
 
+Result<int> Dynamixel::tryGetPresentSpeed() {
+    return tryReadData(Address::PresentSpeed, 2);
+}
+
 int Dynamixel::getPresentLoad() {
-    std::vector<byte> params = {static_cast<byte>(Address::PresentLoad), 2};
-    std::vector<byte> statusPacket = send(Instruction::Read, params);
-    std::vector<byte> data = cleanStatusPacket(statusPacket);
+    Result<int> result = tryGetPresentLoad();
+    if (!result && result.error() != Errc::UnexpectedLength) {
+        throw boost::system::system_error(result.error());
+    }
 
-    // Assert that the packet is the correct size.
-    if (data.size() == 2) {
-        int loadDirection = (data[1] & (1u << 2u)) == 0u ? -1 : 1;
+    return result.valueOr(-1);
+}
 
-        data[1] = static_cast<unsigned char>(3u & data[1]);
+Result<int> Dynamixel::tryGetPresentLoad() {
+    Result<std::vector<byte>> result = tryReadBlock(Address::PresentLoad, 2);
+    if (!result) {
+        return {result.error(), result.servoError()};
+    }
 
-        int absLoad = Utils::convertFromHL(data[0], data[1]);
+    std::vector<byte> data = std::move(result).value();
+    // Bit 10 is set for a clockwise load.
+    int loadDirection = (data[1] & (1u << 2u)) != 0u ? -1 : 1;
 
-        return loadDirection * absLoad;
-    }
+    data[1] = static_cast<unsigned char>(3u & data[1]);
+
+    int absLoad = Utils::convertFromHL(data[0], data[1]);
 
-    return -1;
+    return {loadDirection * absLoad, result.servoError()};
 }
 
 int Dynamixel::getPresentVoltage() {
     return readData(Address::PresentVoltage, 1);
 }
 
+Result<int> Dynamixel::tryGetPresentVoltage() {
+    return tryReadData(Address::PresentVoltage, 1);
+}
+
 int Dynamixel::getPresentTemperature() {
     return readData(Address::PresentTemperature, 1);
 }
 
+Result<int> Dynamixel::tryGetPresentTemperature() {
+    return tryReadData(Address::PresentTemperature, 1);
+}
+
 bool Dynamixel::isMoving() {
     return readData(Address::Moving, 1) == 1;
 }
 
+Result<bool> Dynamixel::tryIsMoving() {
+    Result<int> result = tryReadData(Address::Moving, 1);
+    if (!result) {
+        return {result.error(), result.servoError()};
+    }
+
+    return {result.value() == 1, result.servoError()};
+}
+
 bool Dynamixel::isLocked() {
     return readData(Address::Lock, 1) == 1;
 }
@@ -367,11 +595,19 @@ void Dynamixel::setId(byte newId) {
 }
 
 void Dynamixel::setBaudRate(unsigned int baudRate) {
-    writeData(Address::BaudRate, {static_cast<byte>(round(2000000.0 / baudRate) - 1)});
+    trySetBaudRate(baudRate).value();
+}
+
+Result<void> Dynamixel::trySetBaudRate(unsigned int baudRate) {
+    return tryWriteData(Address::BaudRate, {static_cast<byte>(std::round(2000000.0 / baudRate) - 1)});
 }
 
 void Dynamixel::setReturnDelayTime(int returnDelayTime) {
-    writeData(Address::ReturnDelayTime, {static_cast<byte>(returnDelayTime)});
+    trySetReturnDelayTime(returnDelayTime).value();
+}
+
+Result<void> Dynamixel::trySetReturnDelayTime(int returnDelayTime) {
+    return tryWriteData(Address::ReturnDelayTime, {static_cast<byte>(returnDelayTime)});
 }
 
 void Dynamixel::setCWAngleLimit(short angleLimit) {
@@ -389,17 +625,45 @@ void Dynamixel::setMovingSpeed(short speed) {
     writeData(Address::MovingSpeed, data);
 }
 
+Result<void> Dynamixel::trySetMovingSpeed(short speed) {
+    return tryWriteData(Address::MovingSpeed, Utils::convertToHL(speed));
+}
+
+std::future<void> Dynamixel::queueSetMovingSpeed(short speed) {
+    return queueWriteData(Address::MovingSpeed, Utils::convertToHL(speed));
+}
+
 void Dynamixel::setGoalPosition(short position) {
     std::vector<byte> data = Utils::convertToHL(position);
     writeData(Address::GoalPosition, data);
 }
 
+Result<void> Dynamixel::trySetGoalPosition(short position) {
+    return tryWriteData(Address::GoalPosition, Utils::convertToHL(position));
+}
+
+std::future<void> Dynamixel::queueSetGoalPosition(short position) {
+    return queueWriteData(Address::GoalPosition, Utils::convertToHL(position));
+}
+
 void Dynamixel::moveTo(short position, short speed) {
-    std::vector<byte> posData = Utils::convertToHL(position);
+    tryMoveTo(position, speed).value();
+}
+
+Result<void> Dynamixel::tryMoveTo(short position, short speed) {
+    return tryWriteData(Address::GoalPosition, getMoveData(position, speed));
+}
+
+std::future<void> Dynamixel::queueMoveTo(short position, short speed) {
+    return queueWriteData(Address::GoalPosition, getMoveData(position, speed));
+}
+
+std::vector<Dynamixel::byte> Dynamixel::getMoveData(short position, short speed) {
+    std::vector<byte> data = Utils::convertToHL(position);
     std::vector<byte> speedData = Utils::convertToHL(speed);
-    posData.insert(posData.end(), speedData.begin(), speedData.end());
+    data.insert(data.end(), speedData.begin(), speedData.end());
 
-    writeData(Address::GoalPosition, posData);
+    return data;
 }
 
 void Dynamixel::factoryReset() {
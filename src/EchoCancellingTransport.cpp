@@ -0,0 +1,69 @@
+#include "dynamixel/EchoCancellingTransport.h"
+
+#include "dynamixel/Result.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace goliath::dynamixel;
+
+EchoCancellingTransport::EchoCancellingTransport(std::shared_ptr<Transport> transport)
+        : transport(std::move(transport)) {
+    setTimeout(this->transport->getTimeout());
+}
+
+size_t EchoCancellingTransport::write(boost::asio::const_buffer data, boost::system::error_code &error) {
+    size_t written = transport->write(data, error);
+    cancelEcho(&data, 1, written, error);
+
+    return written;
+}
+
+size_t EchoCancellingTransport::write(const std::vector<boost::asio::const_buffer> &buffers,
+                                      boost::system::error_code &error) {
+    size_t written = transport->write(buffers, error);
+    cancelEcho(buffers.data(), buffers.size(), written, error);
+
+    return written;
+}
+
+size_t EchoCancellingTransport::read(boost::asio::mutable_buffer buffer, Clock::time_point deadline,
+                                     boost::system::error_code &error) {
+    return transport->read(buffer, deadline, error);
+}
+
+void EchoCancellingTransport::flush(FlushType what) {
+    transport->flush(what);
+}
+
+uint64_t EchoCancellingTransport::getContentions() const {
+    return contentions;
+}
+
+void EchoCancellingTransport::cancelEcho(const boost::asio::const_buffer *buffers, size_t count, size_t size,
+                                         boost::system::error_code &error) {
+    if (size == 0) {
+        return;
+    }
+
+    // Even after a failed write, the bytes that went out are echoed and must not be taken for a reply.
+    boost::system::error_code echoError;
+    echo.resize(size);
+    size_t received = transport->read(boost::asio::buffer(echo), Clock::now() + getTimeout(), echoError);
+
+    bool matches = received == size;
+    size_t offset = 0;
+    for (auto buffer = buffers; matches && buffer != buffers + count && offset < size; ++buffer) {
+        size_t length = std::min(buffer->size(), size - offset);
+        matches = std::memcmp(echo.data() + offset, buffer->data(), length) == 0;
+        offset += length;
+    }
+
+    if (!matches) {
+        ++contentions;
+        // Whatever the other device sent would be parsed as the status packet otherwise.
+        transport->flush(FlushType::Receive);
+        if (!error) {
+            error = Errc::BusContention;
+        }
+    }
+}
@@ -0,0 +1,226 @@
+#include "dynamixel/EepromSnapshot.h"
+
+#include <boost/system/system_error.hpp>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+using namespace goliath::dynamixel;
+
+namespace {
+    // The file starts with the magic, version and number of entries (little-endian), followed by
+    // [ID, EEPROM...] per unit.
+    constexpr char Magic[8] = {'D', 'X', 'L', 'E', 'E', 'P', 0, 0};
+    constexpr uint32_t CurrentVersion = 1;
+
+    // Units stop answering as soon as their status return level is lowered, so it's written on its own, last.
+    constexpr size_t StatusReturnLevel = static_cast<size_t>(Dynamixel::Address::StatusReturnLevel);
+
+    void writeUint32(std::ostream &file, uint32_t value) {
+        for (unsigned i = 0; i < 4; ++i) {
+            file.put(static_cast<char>(value >> (8u * i)));
+        }
+    }
+
+    uint32_t readUint32(std::istream &file) {
+        uint32_t value = 0;
+        for (unsigned i = 0; i < 4; ++i) {
+            value |= static_cast<uint32_t>(static_cast<unsigned char>(file.get())) << (8u * i);
+        }
+
+        return value;
+    }
+
+    boost::system::error_code readEntry(Dynamixel &servo, int tries, EepromSnapshot::Entry &entry) {
+        Result<std::vector<Dynamixel::byte>> result = servo.tryReadBlock(Dynamixel::Address::ModelNumber,
+                                                                          EepromSnapshot::EepromSize, tries);
+        if (!result) {
+            return result.error();
+        }
+
+        entry.id = static_cast<Dynamixel::byte>(servo.getId());
+        std::copy(result.value().begin(), result.value().end(), entry.data.begin());
+        return {};
+    }
+}
+
+size_t EepromSnapshot::read(const std::vector<std::shared_ptr<Dynamixel>> &servos, int tries) {
+    size_t succeeded = 0;
+    for (const auto &servo : servos) {
+        Entry entry{};
+        if (!readEntry(*servo, tries, entry)) {
+            set(entry);
+            ++succeeded;
+        }
+    }
+
+    return succeeded;
+}
+
+void EepromSnapshot::save(const std::string &path) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+    auto count = static_cast<uint32_t>(entries.size());
+    file.write(Magic, sizeof(Magic));
+    writeUint32(file, CurrentVersion);
+    writeUint32(file, count);
+    for (const Entry &entry : entries) {
+        file.put(static_cast<char>(entry.id));
+        file.write(reinterpret_cast<const char *>(entry.data.data()), EepromSize);
+    }
+
+    file.close();
+    if (!file) {
+        throw std::runtime_error("Couldn't write EEPROM snapshot: " + path);
+    }
+}
+
+void EepromSnapshot::load(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Couldn't read EEPROM snapshot: " + path);
+    }
+
+    char magic[sizeof(Magic)];
+    file.read(magic, sizeof(magic));
+    uint32_t version = readUint32(file);
+    uint32_t count = readUint32(file);
+    if (!file || std::memcmp(magic, Magic, sizeof(Magic)) != 0 || version != CurrentVersion) {
+        throw std::runtime_error("Unsupported EEPROM snapshot: " + path);
+    }
+
+    // Check the count against the size of the file before trusting it with an allocation.
+    std::streampos entriesStart = file.tellg();
+    file.seekg(0, std::ios::end);
+    auto remaining = static_cast<uint64_t>(file.tellg() - entriesStart);
+    file.seekg(entriesStart);
+    if (!file || static_cast<uint64_t>(count) * (1 + EepromSize) > remaining) {
+        throw std::runtime_error("Truncated EEPROM snapshot: " + path);
+    }
+
+    std::vector<Entry> loaded(count);
+    for (Entry &entry : loaded) {
+        entry.id = static_cast<byte>(file.get());
+        file.read(reinterpret_cast<char *>(entry.data.data()), EepromSize);
+    }
+    if (!file) {
+        throw std::runtime_error("Truncated EEPROM snapshot: " + path);
+    }
+
+    entries = std::move(loaded);
+}
+
+const std::vector<EepromSnapshot::Entry> &EepromSnapshot::getEntries() const {
+    return entries;
+}
+
+const EepromSnapshot::Entry *EepromSnapshot::find(byte id) const {
+    auto entry = std::find_if(entries.begin(), entries.end(), [id](const Entry &entry) {
+        return entry.id == id;
+    });
+
+    return entry != entries.end() ? &*entry : nullptr;
+}
+
+std::vector<EepromSnapshot::Change> EepromSnapshot::diff(const EepromSnapshot &desired, size_t maxGap) const {
+    std::vector<Change> changes;
+    for (const Entry &present : entries) {
+        const Entry *target = desired.find(present.id);
+        if (target != nullptr) {
+            diff(present, *target, maxGap, changes);
+        }
+    }
+
+    return changes;
+}
+
+std::vector<EepromSnapshot::Change> EepromSnapshot::restore(const std::vector<std::shared_ptr<Dynamixel>> &servos,
+                                                            size_t maxGap, int tries) const {
+    std::vector<Change> changes;
+    for (const auto &servo : servos) {
+        const Entry *desired = find(static_cast<byte>(servo->getId()));
+        if (desired == nullptr) {
+            continue;
+        }
+
+        Entry present{};
+        boost::system::error_code error = readEntry(*servo, tries, present);
+        if (error) {
+            throw boost::system::system_error(error, "Reading the EEPROM of Dynamixel " +
+                                                     std::to_string(servo->getId()));
+        }
+
+        size_t first = changes.size();
+        diff(present, *desired, maxGap, changes);
+
+        for (size_t i = first; i < changes.size(); ++i) {
+            std::vector<byte> params = {static_cast<byte>(changes[i].address)};
+            params.insert(params.end(), changes[i].data.begin(), changes[i].data.end());
+
+            // The unit may not answer the write of its status return level, so don't wait for it.
+            boost::system::error_code writeError;
+            if (static_cast<size_t>(changes[i].address) == StatusReturnLevel) {
+                writeError = servo->trySendWithoutReply(Dynamixel::Instruction::Write, params).error();
+            } else {
+                writeError = servo->trySend(Dynamixel::Instruction::Write, params, tries).error();
+            }
+
+            if (writeError) {
+                throw boost::system::system_error(writeError, "Writing the EEPROM of Dynamixel " +
+                                                              std::to_string(servo->getId()));
+            }
+        }
+    }
+
+    return changes;
+}
+
+bool EepromSnapshot::isRestorable(size_t address) {
+    return address >= static_cast<size_t>(Dynamixel::Address::ReturnDelayTime) &&
+           address <= static_cast<size_t>(Dynamixel::Address::AlarmShutdown) &&
+           address != static_cast<size_t>(Dynamixel::Address::SystemData2);
+}
+
+void EepromSnapshot::set(const Entry &entry) {
+    auto existing = std::find_if(entries.begin(), entries.end(), [&entry](const Entry &other) {
+        return other.id == entry.id;
+    });
+
+    if (existing != entries.end()) {
+        *existing = entry;
+    } else {
+        entries.push_back(entry);
+    }
+}
+
+void EepromSnapshot::diff(const Entry &present, const Entry &desired, size_t maxGap, std::vector<Change> &changes) {
+    auto isCoalesced = [](size_t address) {
+        return isRestorable(address) && address != StatusReturnLevel;
+    };
+
+    size_t address = 0;
+    while (address < EepromSize) {
+        if (!isCoalesced(address) || present.data[address] == desired.data[address]) {
+            ++address;
+            continue;
+        }
+
+        // Extend the range up to the last change that can be reached over a short enough writable gap.
+        size_t end = address + 1;
+        for (size_t next = end; next < EepromSize && isCoalesced(next) && next - end <= maxGap; ++next) {
+            if (present.data[next] != desired.data[next]) {
+                end = next + 1;
+            }
+        }
+
+        changes.push_back({desired.id, static_cast<Dynamixel::Address>(address),
+                           std::vector<byte>(desired.data.begin() + address, desired.data.begin() + end)});
+        address = end;
+    }
+
+    if (present.data[StatusReturnLevel] != desired.data[StatusReturnLevel]) {
+        changes.push_back({desired.id, Dynamixel::Address::StatusReturnLevel,
+                           {desired.data[StatusReturnLevel]}});
+    }
+}
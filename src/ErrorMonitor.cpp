@@ -0,0 +1,114 @@
+#include "dynamixel/ErrorMonitor.h"
+
+#include <boost/log/trivial.hpp>
+
+using namespace goliath::dynamixel;
+
+namespace {
+    // Indexed by error bit (see the official Dynamixel AX-12 User's manual p.21).
+    const char *const errorDescriptions[ErrorMonitor::ErrorBits] = {
+            "Input voltage error: applied voltage is out of the range.",
+            "Angle limit error: goal position is not between CW angle limit and CCW.",
+            "Overheating error: internal temperature is out of the range.",
+            "Range error: given command is beyond the range of usage.",
+            "Checksum error: the checksum of the transmitted instruction packet is invalid.",
+            "Overload error: the current load cannot be controlled with the set maximum torque.",
+            "Instruction error: a undefined instruction is transmitted."
+    };
+}
+
+ErrorMonitor::ErrorMonitor(size_t eventCapacity, Clock::duration logInterval) : logInterval(logInterval),
+                                                                                events(eventCapacity) {
+}
+
+std::shared_ptr<ErrorMonitor> ErrorMonitor::getDefault() {
+    static std::shared_ptr<ErrorMonitor> monitor = std::make_shared<ErrorMonitor>();
+    return monitor;
+}
+
+void ErrorMonitor::record(byte id, byte flags) {
+    if (id > MaxId) {
+        return;
+    }
+
+    auto now = Clock::now();
+    bool log = false;
+    uint32_t suppressed = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        State &state = states[id];
+        Statistics &statistics = state.statistics;
+
+        if (flags != statistics.flags && !events.empty()) {
+            events[eventCount++ % events.size()] = {id, flags, now};
+        }
+        statistics.flags = flags;
+
+        if (flags == 0) {
+            state.loggedFlags = 0;
+            return;
+        }
+
+        ++statistics.packets;
+        for (size_t bit = 0; bit < ErrorBits; ++bit) {
+            if ((flags & (1u << bit)) != 0u) {
+                ++statistics.counts[bit];
+                statistics.lastSeen[bit] = now;
+            }
+        }
+
+        // Log new errors right away, repeated ones at most once per interval.
+        if (flags != state.loggedFlags || now >= state.nextLog) {
+            log = true;
+            suppressed = state.suppressed;
+            state.loggedFlags = flags;
+            state.nextLog = now + logInterval;
+            state.suppressed = 0;
+        } else {
+            ++state.suppressed;
+        }
+    }
+
+    if (log) {
+        BOOST_LOG_TRIVIAL(warning) << "Dynamixel " << static_cast<int>(id) << ": " << describe(flags)
+                                   << (suppressed > 0 ? " (repeated " + std::to_string(suppressed) + " times)" : "");
+    }
+}
+
+ErrorMonitor::Statistics ErrorMonitor::getStatistics(byte id) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return id <= MaxId ? states[id].statistics : Statistics();
+}
+
+std::vector<ErrorMonitor::Event> ErrorMonitor::getEvents() const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::vector<Event> result;
+    size_t count = std::min(eventCount, events.size());
+    result.reserve(count);
+    for (size_t i = eventCount - count; i < eventCount; ++i) {
+        result.push_back(events[i % events.size()]);
+    }
+
+    return result;
+}
+
+void ErrorMonitor::reset() {
+    std::lock_guard<std::mutex> lock(mutex);
+    states.fill(State());
+    eventCount = 0;
+}
+
+std::string ErrorMonitor::describe(byte flags) {
+    std::string description;
+    for (size_t bit = ErrorBits; bit-- > 0;) {
+        if ((flags & (1u << bit)) != 0u) {
+            if (!description.empty()) {
+                description += ' ';
+            }
+            description += errorDescriptions[bit];
+        }
+    }
+
+    return description;
+}
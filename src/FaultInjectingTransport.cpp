@@ -0,0 +1,122 @@
+#include "dynamixel/FaultInjectingTransport.h"
+
+#include <boost/asio/error.hpp>
+#include <algorithm>
+#include <thread>
+
+using namespace goliath::dynamixel;
+
+FaultInjectingTransport::Faults FaultInjectingTransport::Faults::scaled(double factor) const {
+    Faults result = *this;
+    result.bitFlipRate = std::min(1.0, bitFlipRate * factor);
+    result.dropRate = std::min(1.0, dropRate * factor);
+    result.strayRate = std::min(1.0, strayRate * factor);
+    result.delayRate = std::min(1.0, delayRate * factor);
+    result.silentRate = std::min(1.0, silentRate * factor);
+
+    return result;
+}
+
+FaultInjectingTransport::FaultInjectingTransport(std::shared_ptr<Transport> transport, Faults faults, uint32_t seed)
+        : transport(std::move(transport)), faults(faults), random(seed), chance(0.0, 1.0) {
+    setTimeout(this->transport->getTimeout());
+}
+
+size_t FaultInjectingTransport::write(boost::asio::const_buffer data, boost::system::error_code &error) {
+    startReply();
+    return transport->write(data, error);
+}
+
+size_t FaultInjectingTransport::write(const std::vector<boost::asio::const_buffer> &buffers,
+                                      boost::system::error_code &error) {
+    startReply();
+    return transport->write(buffers, error);
+}
+
+size_t FaultInjectingTransport::read(boost::asio::mutable_buffer buffer, Clock::time_point deadline,
+                                     boost::system::error_code &error) {
+    auto first = static_cast<byte *>(buffer.data());
+    size_t size = buffer.size();
+    error = boost::system::error_code();
+
+    if (replyStarted) {
+        replyStarted = false;
+
+        if (silent) {
+            // The reply is lost; whatever arrives is flushed before the next write.
+            std::this_thread::sleep_until(deadline);
+            error = boost::asio::error::timed_out;
+            return 0;
+        }
+
+        if (chance(random) < faults.delayRate) {
+            ++statistics.delays;
+            std::this_thread::sleep_until(std::min(deadline, Clock::now() + faults.delay));
+        }
+    }
+
+    // Drops make the inner transport deliver too few bytes, so keep reading until the deadline.
+    std::vector<byte> chunk;
+    while (pending.size() < size && !error) {
+        chunk.resize(size - pending.size());
+        size_t received = transport->read(boost::asio::buffer(chunk), deadline, error);
+        corrupt(chunk.data(), received);
+    }
+    if (pending.size() >= size) {
+        error = boost::system::error_code();
+    }
+
+    size_t bytesReceived = std::min(size, pending.size());
+    std::copy(pending.begin(), pending.begin() + bytesReceived, first);
+    pending.erase(pending.begin(), pending.begin() + bytesReceived);
+
+    return bytesReceived;
+}
+
+void FaultInjectingTransport::flush(FlushType what) {
+    if (what != FlushType::Send) {
+        pending.clear();
+    }
+    transport->flush(what);
+}
+
+void FaultInjectingTransport::setFaults(const Faults &faults) {
+    this->faults = faults;
+}
+
+const FaultInjectingTransport::Faults &FaultInjectingTransport::getFaults() const {
+    return faults;
+}
+
+const FaultInjectingTransport::Statistics &FaultInjectingTransport::getStatistics() const {
+    return statistics;
+}
+
+void FaultInjectingTransport::startReply() {
+    replyStarted = true;
+    silent = chance(random) < faults.silentRate;
+    if (silent) {
+        ++statistics.silences;
+    }
+}
+
+void FaultInjectingTransport::corrupt(const byte *data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        if (chance(random) < faults.strayRate) {
+            ++statistics.strays;
+            pending.push_back(static_cast<byte>(random()));
+        }
+
+        if (chance(random) < faults.dropRate) {
+            ++statistics.drops;
+            continue;
+        }
+
+        byte value = data[i];
+        if (chance(random) < faults.bitFlipRate) {
+            ++statistics.bitFlips;
+            value ^= static_cast<byte>(1u << (random() % 8u));
+        }
+        pending.push_back(value);
+    }
+}
@@ -0,0 +1,49 @@
+#include "dynamixel/GroupRead.h"
+
+using namespace goliath::dynamixel;
+
+namespace {
+    // From *present position* up to and including *present temperature*.
+    constexpr size_t StateLength =
+            static_cast<size_t>(Dynamixel::Address::PresentTemperature) -
+            static_cast<size_t>(Dynamixel::Address::PresentPosition) + 1;
+}
+
+GroupRead::GroupRead(std::vector<std::shared_ptr<Dynamixel>> servos, int tries) : servos(std::move(servos)),
+                                                                                  tries(tries) {
+}
+
+size_t GroupRead::read(RawState &state) {
+    state.resize(servos.size());
+
+    size_t succeeded = 0;
+    for (size_t i = 0; i < servos.size(); ++i) {
+        Dynamixel &servo = *servos[i];
+        state.ids[i] = static_cast<uint8_t>(servo.getId());
+
+        Result<std::vector<Dynamixel::byte>> result = servo.tryReadBlock(Dynamixel::Address::PresentPosition,
+                                                                          StateLength, tries);
+        state.errors[i] = result.servoError();
+        state.valid[i] = result.ok();
+        if (!result) {
+            continue;
+        }
+
+        // [position L, position H, speed L, speed H, load L, load H, voltage, temperature]
+        const std::vector<Dynamixel::byte> &data = result.value();
+        state.position[i] = static_cast<uint16_t>(data[0] | (data[1] << 8u));
+        state.speed[i] = static_cast<uint16_t>(data[2] | (data[3] << 8u));
+        state.load[i] = static_cast<uint16_t>(data[4] | (data[5] << 8u));
+        state.voltage[i] = data[6];
+        state.temperature[i] = data[7];
+        state.transmitted[i] = servo.getLastTiming().transmitted;
+        state.received[i] = servo.getLastTiming().received;
+        ++succeeded;
+    }
+
+    return succeeded;
+}
+
+const std::vector<std::shared_ptr<Dynamixel>> &GroupRead::getServos() const {
+    return servos;
+}
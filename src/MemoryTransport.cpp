@@ -0,0 +1,102 @@
+#include "dynamixel/MemoryTransport.h"
+
+#include <boost/asio/error.hpp>
+
+using namespace goliath::dynamixel;
+
+MemoryTransport::MemoryTransport(Responder responder) {
+    setResponder(std::move(responder));
+}
+
+MemoryTransport::MemoryTransport(ReplyWriter writer) {
+    setReplyWriter(std::move(writer));
+}
+
+size_t MemoryTransport::write(boost::asio::const_buffer data, boost::system::error_code &error) {
+    auto first = static_cast<const byte *>(data.data());
+    size_t size = data.size();
+
+    std::shared_ptr<const ReplyWriter> current;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (recording) {
+            tx.insert(tx.end(), first, first + size);
+        }
+        current = writer;
+    }
+
+    if (current) {
+        reply.clear();
+        (*current)(first, size, reply);
+        feed(reply);
+    }
+
+    error = boost::system::error_code();
+    return size;
+}
+
+size_t MemoryTransport::read(boost::asio::mutable_buffer buffer, Clock::time_point deadline,
+                             boost::system::error_code &error) {
+    auto first = static_cast<byte *>(buffer.data());
+    size_t size = buffer.size();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    bool complete = received.wait_until(lock, deadline, [this, size] {
+        return rx.size() >= size;
+    });
+
+    size_t bytesReceived = std::min(size, rx.size());
+    std::copy(rx.begin(), rx.begin() + bytesReceived, first);
+    rx.erase(rx.begin(), rx.begin() + bytesReceived);
+
+    error = complete ? boost::system::error_code() : boost::asio::error::timed_out;
+    return bytesReceived;
+}
+
+void MemoryTransport::flush(FlushType what) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (what != FlushType::Send) {
+        rx.clear();
+    }
+}
+
+void MemoryTransport::setResponder(Responder responder) {
+    if (!responder) {
+        setReplyWriter(nullptr);
+        return;
+    }
+
+    setReplyWriter([responder = std::move(responder)](const byte *data, size_t size, std::vector<byte> &reply) {
+        reply = responder(data, size);
+    });
+}
+
+void MemoryTransport::setReplyWriter(ReplyWriter writer) {
+    std::shared_ptr<const ReplyWriter> shared;
+    if (writer) {
+        shared = std::make_shared<const ReplyWriter>(std::move(writer));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    this->writer = std::move(shared);
+}
+
+void MemoryTransport::setRecording(bool recording) {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->recording = recording;
+}
+
+void MemoryTransport::feed(const std::vector<byte> &data) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        rx.insert(rx.end(), data.begin(), data.end());
+    }
+    received.notify_all();
+}
+
+std::vector<MemoryTransport::byte> MemoryTransport::takeWritten() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<byte> written;
+    written.swap(tx);
+    return written;
+}
@@ -0,0 +1,121 @@
+#include "dynamixel/MotionPlanner.h"
+
+#include "dynamixel/Conversion.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace goliath::dynamixel;
+
+namespace {
+    int distance(uint16_t from, uint16_t to) {
+        return std::abs(static_cast<int>(to) - static_cast<int>(from));
+    }
+
+    int longestTravel(const MotionPlanner::Plan &plan) {
+        int longest = 0;
+        for (size_t i = 0; i < plan.ids.size(); ++i) {
+            longest = std::max(longest, distance(plan.startPosition[i], plan.goalPosition[i]));
+        }
+
+        return longest;
+    }
+}
+
+MotionPlanner::MotionPlanner(std::shared_ptr<Transport> port, std::vector<std::shared_ptr<Dynamixel>> servos,
+                             int tries) : port(std::move(port)), groupRead(std::move(servos), tries) {
+}
+
+MotionPlanner::Plan MotionPlanner::moveIn(const std::vector<uint16_t> &goalPosition, Clock::duration duration) {
+    Plan plan = prepare(goalPosition);
+    schedule(plan, std::chrono::duration<float>(duration).count());
+    send(plan);
+
+    return plan;
+}
+
+MotionPlanner::Plan MotionPlanner::moveWithVelocity(const std::vector<uint16_t> &goalPosition, float maxVelocity) {
+    // A *moving speed* of zero would mean maximum speed, so don't guess.
+    if (!(maxVelocity > 0.0f)) {
+        throw std::invalid_argument("The velocity of a move must be positive");
+    }
+
+    Plan plan = prepare(goalPosition);
+
+    // A velocity above the maximum speed is clamped by `schedule()`, which stretches the duration.
+    schedule(plan, longestTravel(plan) * Conversion::RadiansPerTick / maxVelocity);
+    send(plan);
+
+    return plan;
+}
+
+void MotionPlanner::schedule(Plan &plan, float duration) {
+    int longest = longestTravel(plan);
+    // If the longest travel can't be made in time, everything slows down so the units still arrive together.
+    float shortest = longest / (Conversion::MaxSpeed * Conversion::TicksPerSecondPerSpeedUnit);
+    plan.duration = std::chrono::duration<float>(std::max(duration, shortest));
+
+    plan.movingSpeed.resize(plan.ids.size());
+    for (size_t i = 0; i < plan.ids.size(); ++i) {
+        float speed = plan.duration.count() > 0.0f
+                      ? distance(plan.startPosition[i], plan.goalPosition[i]) /
+                        (plan.duration.count() * Conversion::TicksPerSecondPerSpeedUnit)
+                      : 0.0f;
+
+        // Zero would mean "maximum speed without velocity control", so a joint that doesn't move gets the minimum.
+        plan.movingSpeed[i] = static_cast<uint16_t>(std::clamp(std::lround(speed), 1L,
+                                                               static_cast<long>(Conversion::MaxSpeed)));
+    }
+}
+
+std::vector<SyncWrite> MotionPlanner::getSyncWrites(const Plan &plan) {
+    // *Goal position* and *moving speed* are adjacent in the control table.
+    constexpr size_t Length = 4;
+
+    std::vector<SyncWrite> syncWrites;
+    for (size_t i = 0; i < plan.ids.size(); ++i) {
+        if (syncWrites.empty() || syncWrites.back().size() == SyncWrite::getMaxUnits(Length)) {
+            syncWrites.emplace_back(Dynamixel::Address::GoalPosition, Length);
+        }
+
+        syncWrites.back().add(plan.ids[i], {
+                static_cast<byte>(plan.goalPosition[i]),
+                static_cast<byte>(plan.goalPosition[i] >> 8u),
+                static_cast<byte>(plan.movingSpeed[i]),
+                static_cast<byte>(plan.movingSpeed[i] >> 8u)
+        });
+    }
+
+    return syncWrites;
+}
+
+void MotionPlanner::send(const Plan &plan) {
+    for (const SyncWrite &syncWrite : getSyncWrites(plan)) {
+        syncWrite.send(*port);
+    }
+}
+
+MotionPlanner::Plan MotionPlanner::prepare(const std::vector<uint16_t> &goalPosition) {
+    if (goalPosition.size() != groupRead.getServos().size()) {
+        throw std::invalid_argument("Expected " + std::to_string(groupRead.getServos().size()) + " goal positions");
+    }
+
+    if (groupRead.read(state) != state.size()) {
+        for (size_t i = 0; i < state.size(); ++i) {
+            if (!state.valid[i]) {
+                throw std::runtime_error("Couldn't read the present position of Dynamixel " +
+                                         std::to_string(state.ids[i]));
+            }
+        }
+    }
+
+    Plan plan;
+    plan.ids = state.ids;
+    plan.startPosition = state.position;
+    plan.goalPosition.resize(goalPosition.size());
+    for (size_t i = 0; i < goalPosition.size(); ++i) {
+        plan.goalPosition[i] = std::min(goalPosition[i], Conversion::MaxPosition);
+    }
+
+    return plan;
+}
@@ -0,0 +1,119 @@
+#include "dynamixel/PreparedCommand.h"
+
+#include "dynamixel/SyncWrite.h"
+#include <stdexcept>
+#include <string>
+
+using namespace goliath::dynamixel;
+
+namespace {
+    // [0xFF, 0xFF, ID, LENGTH, INSTRUCTION] precede the parameters.
+    constexpr size_t HeaderSize = 5;
+
+    size_t checkWidth(size_t width) {
+        if (width != 1 && width != 2) {
+            throw std::invalid_argument("Prepared packets write 1 or 2 byte values");
+        }
+
+        return width;
+    }
+
+    std::vector<Dynamixel::byte> getWriteData(Dynamixel::Address address, size_t width) {
+        // [ADDRESS, VALUE...]
+        std::vector<Dynamixel::byte> data(1 + checkWidth(width), 0);
+        data[0] = static_cast<Dynamixel::byte>(address);
+
+        return data;
+    }
+
+    std::vector<Dynamixel::byte> getSyncWriteData(Dynamixel::Address address, size_t width,
+                                                  const std::vector<Dynamixel::byte> &ids) {
+        if (ids.size() > SyncWrite::getMaxUnits(checkWidth(width))) {
+            throw std::invalid_argument("A SYNC WRITE of " + std::to_string(width) + " byte values fits at most " +
+                                        std::to_string(SyncWrite::getMaxUnits(width)) + " units");
+        }
+
+        // [ADDRESS, LENGTH, ID1, VALUE1..., ID2, VALUE2..., ...]
+        std::vector<Dynamixel::byte> data(2 + ids.size() * (1 + width), 0);
+        data[0] = static_cast<Dynamixel::byte>(address);
+        data[1] = static_cast<Dynamixel::byte>(width);
+        for (size_t i = 0; i < ids.size(); ++i) {
+            data[2 + i * (1 + width)] = ids[i];
+        }
+
+        return data;
+    }
+}
+
+PreparedPacket::PreparedPacket(byte id, Dynamixel::Instruction instruction, const std::vector<byte> &data)
+        : packet(Dynamixel::getInstructionPacket(id, instruction, data)) {
+    // The checksum is the inverted sum, so the sum can be recovered from it.
+    sum = static_cast<byte>(~packet.back());
+}
+
+const std::vector<PreparedPacket::byte> &PreparedPacket::getPacket() const {
+    return packet;
+}
+
+boost::asio::const_buffer PreparedPacket::buffer() const {
+    return boost::asio::buffer(packet);
+}
+
+void PreparedPacket::patch(size_t offset, size_t width, uint16_t value) {
+    for (size_t i = 0; i < width; ++i) {
+        auto newByte = static_cast<byte>(value >> (8u * i));
+        sum += newByte - packet[offset + i];
+        packet[offset + i] = newByte;
+    }
+
+    packet.back() = static_cast<byte>(~sum);
+}
+
+PreparedCommand::PreparedCommand(std::shared_ptr<Dynamixel> servo, Dynamixel::Instruction instruction,
+                                 Dynamixel::Address address, size_t width)
+        : PreparedPacket(static_cast<byte>(servo->getId()), instruction, getWriteData(address, width)),
+          servo(std::move(servo)), width(width) {
+}
+
+void PreparedCommand::set(uint16_t value) {
+    patch(HeaderSize + 1, width, value);
+}
+
+Result<void> PreparedCommand::send(int tries) {
+    Result<std::vector<byte>> result = servo->trySendPacket(getPacket(), tries);
+    return {result.error(), result.servoError()};
+}
+
+PreparedSyncWrite::PreparedSyncWrite(Dynamixel::Address address, size_t width, const std::vector<byte> &ids)
+        : PreparedPacket(Dynamixel::BroadcastId, Dynamixel::Instruction::SyncWrite,
+                         getSyncWriteData(address, width, ids)),
+          width(width), units(ids.size()) {
+}
+
+void PreparedSyncWrite::set(size_t index, uint16_t value) {
+    if (index >= units) {
+        throw std::out_of_range("Unit " + std::to_string(index) + " isn't written to, the packet has " +
+                                std::to_string(units) + " units");
+    }
+
+    patchUnit(index, value);
+}
+
+void PreparedSyncWrite::set(const uint16_t *values) {
+    for (size_t i = 0; i < units; ++i) {
+        patchUnit(i, values[i]);
+    }
+}
+
+void PreparedSyncWrite::patchUnit(size_t index, uint16_t value) {
+    patch(HeaderSize + 2 + index * (1 + width) + 1, width, value);
+}
+
+size_t PreparedSyncWrite::size() const {
+    return units;
+}
+
+void PreparedSyncWrite::send(Transport &port) const {
+    std::lock_guard<std::recursive_mutex> lock(port.getBusMutex());
+    port.write(buffer());
+}
@@ -0,0 +1,427 @@
+#include "dynamixel/RealTimeWorker.h"
+
+#include "dynamixel/AllocationCounter.h"
+#include "dynamixel/Dynamixel.h"
+#include "dynamixel/Result.h"
+#include "dynamixel/SyncWrite.h"
+#include "dynamixel/Utils.h"
+#include <boost/asio/error.hpp>
+#include <boost/system/system_error.hpp>
+#include <cerrno>
+#include <pthread.h>
+#include <sched.h>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <time.h>
+
+using namespace goliath::dynamixel;
+
+namespace {
+    using Address = Dynamixel::Address;
+    using Instruction = Dynamixel::Instruction;
+
+    // From *present position* up to and including *present temperature*, as read by `GroupRead`.
+    constexpr size_t StateLength =
+            static_cast<size_t>(Address::PresentTemperature) - static_cast<size_t>(Address::PresentPosition) + 1;
+
+    // [0xFF, 0xFF, id, length, instruction, address, length, checksum]
+    constexpr size_t ReadPacketSize = 8;
+    // [0xFF, 0xFF, id, length, error, parameter 1, ..., parameter N, checksum]
+    constexpr size_t StatusPacketSize = 6 + StateLength;
+    // [0xFF, 0xFF, 0xFE, length, 0x83, address, 2] followed by [id, L, H] per unit and the checksum.
+    constexpr size_t SyncWriteHeaderSize = 7;
+
+    // The state of a unit is shared as [position, speed, load, voltage, temperature], [id, errors, valid],
+    // transmitted and received, so it can be copied with atomic loads.
+    constexpr size_t SharedWords = 4;
+
+    // Set on a goal position that wasn't sent yet.
+    constexpr uint32_t Dirty = 1u << 16u;
+
+    // Touched before the loop starts, so the loop doesn't fault stack pages in.
+    constexpr size_t StackReserve = 64 * 1024;
+
+    void prefaultStack() {
+        unsigned char stack[StackReserve];
+        for (size_t i = 0; i < StackReserve; i += 4096) {
+            stack[i] = 0;
+        }
+        // Keep the stores, which are never read.
+        asm volatile("" : : "r"(stack) : "memory");
+    }
+
+    void sleepUntil(std::chrono::steady_clock::time_point time) {
+        // The steady clock is CLOCK_MONOTONIC.
+        auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+
+        timespec wakeup{};
+        wakeup.tv_sec = static_cast<time_t>(nanoseconds / 1000000000);
+        wakeup.tv_nsec = static_cast<long>(nanoseconds % 1000000000);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeup, nullptr) == EINTR) {
+        }
+    }
+
+    void updateMaximum(std::atomic<std::chrono::steady_clock::rep> &maximum, std::chrono::steady_clock::rep value) {
+        auto current = maximum.load(std::memory_order_relaxed);
+        while (value > current && !maximum.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    size_t checkUnits(const std::vector<RealTimeWorker::byte> &ids) {
+        size_t maxUnits = SyncWrite::getMaxUnits(2);
+        if (ids.empty() || ids.size() > maxUnits) {
+            throw std::invalid_argument("A real-time worker controls 1 to " + std::to_string(maxUnits) + " units");
+        }
+
+        return ids.size();
+    }
+}
+
+RealTimeWorker::RealTimeWorker(std::shared_ptr<Transport> transport, const std::vector<byte> &ids,
+                               const Config &config) : transport(std::move(transport)), config(config),
+                                                       count(checkUnits(ids)), arena(config.arenaSize) {
+    if (config.period <= Clock::duration::zero()) {
+        throw std::invalid_argument("The period of a real-time worker must be positive");
+    }
+
+    goals = arena.allocate<std::atomic<uint32_t>>(count);
+    syncWrite = arena.allocate<byte>(SyncWriteHeaderSize + 3 * count + 1);
+    readPackets = arena.allocate<byte>(ReadPacketSize * count);
+    statusPacket = arena.allocate<byte>(StatusPacketSize);
+    shared = arena.allocate<std::atomic<uint64_t>>(SharedWords * count);
+
+    syncWrite[0] = 0xFF;
+    syncWrite[1] = 0xFF;
+    syncWrite[2] = Dynamixel::BroadcastId;
+    syncWrite[4] = static_cast<byte>(Instruction::SyncWrite);
+    syncWrite[5] = static_cast<byte>(Address::GoalPosition);
+    syncWrite[6] = 2;
+
+    for (size_t i = 0; i < count; ++i) {
+        byte *packet = readPackets + ReadPacketSize * i;
+        packet[0] = 0xFF;
+        packet[1] = 0xFF;
+        packet[2] = ids[i];
+        packet[3] = 4;
+        packet[4] = static_cast<byte>(Instruction::Read);
+        packet[5] = static_cast<byte>(Address::PresentPosition);
+        packet[6] = StateLength;
+        packet[7] = Utils::checkSum(packet, ReadPacketSize - 1);
+    }
+
+    state.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        state.ids[i] = ids[i];
+    }
+}
+
+RealTimeWorker::RealTimeWorker(std::shared_ptr<Transport> transport, const std::vector<byte> &ids)
+        : RealTimeWorker(std::move(transport), ids, Config()) {
+}
+
+RealTimeWorker::~RealTimeWorker() {
+    stop();
+}
+
+void RealTimeWorker::setTelemetry(std::shared_ptr<TelemetryPublisher> publisher) {
+    telemetry = std::move(publisher);
+}
+
+void RealTimeWorker::start() {
+    if (running.load(std::memory_order_acquire)) {
+        throw std::logic_error("The real-time worker is running already");
+    }
+
+    if (config.lockMemory && mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        throw boost::system::system_error(errno, boost::system::system_category(), "mlockall");
+    }
+
+    running.store(true, std::memory_order_release);
+
+    std::promise<void> ready;
+    std::future<void> configured = ready.get_future();
+    thread = std::thread([this, &ready] {
+        run(ready);
+    });
+
+    try {
+        configured.get();
+    } catch (...) {
+        stop();
+        throw;
+    }
+}
+
+void RealTimeWorker::stop() {
+    running.store(false, std::memory_order_release);
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+bool RealTimeWorker::isRunning() const {
+    return running.load(std::memory_order_acquire);
+}
+
+void RealTimeWorker::setGoalPosition(size_t index, uint16_t position) {
+    goals[index].store(position | Dirty, std::memory_order_release);
+}
+
+bool RealTimeWorker::getState(RawState &state) const {
+    state.resize(count);
+
+    while (true) {
+        uint64_t sequence = sharedSequence.load(std::memory_order_acquire);
+        if (sequence == 0) {
+            return false;
+        }
+        if (sequence % 2 == 1) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            const std::atomic<uint64_t> *words = shared + SharedWords * i;
+            uint64_t values = words[0].load(std::memory_order_relaxed);
+            uint64_t status = words[1].load(std::memory_order_relaxed);
+
+            state.position[i] = static_cast<uint16_t>(values);
+            state.speed[i] = static_cast<uint16_t>(values >> 16u);
+            state.load[i] = static_cast<uint16_t>(values >> 32u);
+            state.voltage[i] = static_cast<uint8_t>(values >> 48u);
+            state.temperature[i] = static_cast<uint8_t>(values >> 56u);
+            state.ids[i] = static_cast<uint8_t>(status);
+            state.errors[i] = static_cast<uint8_t>(status >> 8u);
+            state.valid[i] = static_cast<uint8_t>(status >> 16u);
+            state.transmitted[i] = Clock::time_point(
+                    Clock::duration(static_cast<Clock::rep>(words[2].load(std::memory_order_relaxed))));
+            state.received[i] = Clock::time_point(
+                    Clock::duration(static_cast<Clock::rep>(words[3].load(std::memory_order_relaxed))));
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sharedSequence.load(std::memory_order_relaxed) == sequence) {
+            return true;
+        }
+    }
+}
+
+RealTimeWorker::Statistics RealTimeWorker::getStatistics() const {
+    Statistics statistics;
+    statistics.cycles = cycles.load(std::memory_order_relaxed);
+    statistics.overruns = overruns.load(std::memory_order_relaxed);
+    statistics.errors = errors.load(std::memory_order_relaxed);
+    statistics.worstLatency = Clock::duration(worstLatency.load(std::memory_order_relaxed));
+    statistics.worstCycle = Clock::duration(worstCycle.load(std::memory_order_relaxed));
+    statistics.allocations = allocations.load(std::memory_order_relaxed);
+    statistics.locks = locks.load(std::memory_order_relaxed);
+
+    return statistics;
+}
+
+void RealTimeWorker::configureThread() {
+    pthread_t self = pthread_self();
+
+    if (config.cpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(config.cpu, &cpus);
+
+        int error = pthread_setaffinity_np(self, sizeof(cpus), &cpus);
+        if (error != 0) {
+            throw boost::system::system_error(error, boost::system::system_category(), "pthread_setaffinity_np");
+        }
+    }
+
+    if (config.priority > 0) {
+        sched_param parameters{};
+        parameters.sched_priority = config.priority;
+
+        int error = pthread_setschedparam(self, SCHED_FIFO, &parameters);
+        if (error != 0) {
+            throw boost::system::system_error(error, boost::system::system_category(), "pthread_setschedparam");
+        }
+    }
+}
+
+void RealTimeWorker::run(std::promise<void> &ready) {
+    try {
+        configureThread();
+    } catch (...) {
+        ready.set_exception(std::current_exception());
+        return;
+    }
+    prefaultStack();
+    ready.set_value();
+
+    uint64_t completed = 0;
+    bool watched = false;
+    uint64_t allocationsBefore = 0;
+    uint64_t locksBefore = 0;
+
+    Clock::time_point next = Clock::now();
+    while (running.load(std::memory_order_acquire)) {
+        sleepUntil(next);
+
+        Clock::time_point start = Clock::now();
+        cycle();
+        Clock::time_point end = Clock::now();
+
+        updateMaximum(worstLatency, (start - next).count());
+        updateMaximum(worstCycle, (end - start).count());
+
+        next += config.period;
+        if (end > next) {
+            // Start the next cycle right away, rather than trying to catch up.
+            overruns.fetch_add(1, std::memory_order_relaxed);
+            next = end;
+        }
+        cycles.store(++completed, std::memory_order_relaxed);
+
+        if (watched) {
+            allocations.store(AllocationCounter::getThreadCount() - allocationsBefore, std::memory_order_relaxed);
+            locks.store(AllocationCounter::getThreadLockCount() - locksBefore, std::memory_order_relaxed);
+        } else if (completed >= config.warmupCycles) {
+            AllocationCounter::watch(true, config.trapAllocations);
+            allocationsBefore = AllocationCounter::getThreadCount();
+            locksBefore = AllocationCounter::getThreadLockCount();
+            watched = true;
+        }
+    }
+
+    AllocationCounter::watch(false);
+}
+
+void RealTimeWorker::cycle() {
+    sendGoals();
+
+    for (size_t i = 0; i < count; ++i) {
+        boost::system::error_code error;
+        try {
+            error = readState(i);
+        } catch (const boost::system::system_error &e) {
+            error = e.code();
+        }
+
+        state.valid[i] = !error;
+        if (error) {
+            errors.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t sequence = sharedSequence.load(std::memory_order_relaxed);
+    sharedSequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < count; ++i) {
+        std::atomic<uint64_t> *words = shared + SharedWords * i;
+        words[0].store(state.position[i] | static_cast<uint64_t>(state.speed[i]) << 16u |
+                       static_cast<uint64_t>(state.load[i]) << 32u | static_cast<uint64_t>(state.voltage[i]) << 48u |
+                       static_cast<uint64_t>(state.temperature[i]) << 56u, std::memory_order_relaxed);
+        words[1].store(state.ids[i] | static_cast<uint64_t>(state.errors[i]) << 8u |
+                       static_cast<uint64_t>(state.valid[i]) << 16u, std::memory_order_relaxed);
+        words[2].store(static_cast<uint64_t>(state.transmitted[i].time_since_epoch().count()),
+                       std::memory_order_relaxed);
+        words[3].store(static_cast<uint64_t>(state.received[i].time_since_epoch().count()),
+                       std::memory_order_relaxed);
+    }
+    sharedSequence.store(sequence + 2, std::memory_order_release);
+
+    if (telemetry) {
+        telemetry->publish(state);
+    }
+}
+
+void RealTimeWorker::sendGoals() {
+    byte *parameters = syncWrite + SyncWriteHeaderSize;
+
+    size_t dirty = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!(goals[i].load(std::memory_order_relaxed) & Dirty)) {
+            continue;
+        }
+
+        uint32_t goal = goals[i].fetch_and(~Dirty, std::memory_order_acq_rel);
+        parameters[3 * dirty] = state.ids[i];
+        parameters[3 * dirty + 1] = static_cast<byte>(goal & 0xFFu);
+        parameters[3 * dirty + 2] = static_cast<byte>((goal >> 8u) & 0xFFu);
+        ++dirty;
+    }
+
+    if (dirty == 0) {
+        return;
+    }
+
+    size_t size = SyncWriteHeaderSize + 3 * dirty + 1;
+    syncWrite[3] = static_cast<byte>(3 * dirty + 4);
+    syncWrite[size - 1] = Utils::checkSum(syncWrite, size - 1);
+
+    boost::system::error_code error;
+    transport->write(boost::asio::buffer(syncWrite, size), error);
+    if (error) {
+        errors.fetch_add(1, std::memory_order_relaxed);
+
+        // Send the goals again with the next cycle, unless they were replaced in the meantime.
+        for (size_t i = 0; i < count; ++i) {
+            for (size_t j = 0; j < dirty; ++j) {
+                if (parameters[3 * j] == state.ids[i]) {
+                    goals[i].fetch_or(Dirty, std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+}
+
+boost::system::error_code RealTimeWorker::readState(size_t index) {
+    byte id = state.ids[index];
+    boost::system::error_code error;
+
+    transport->flush(Transport::FlushType::Receive);
+    state.transmitted[index] = Clock::now();
+    transport->write(boost::asio::buffer(readPackets + ReadPacketSize * index, ReadPacketSize), error);
+    if (error) {
+        return error;
+    }
+
+    auto deadline = Clock::now() + transport->getTimeout();
+    size_t received = transport->read(boost::asio::buffer(statusPacket, 5), deadline, error);
+    if (error == boost::asio::error::timed_out) {
+        return received == 0 ? Errc::Timeout : Errc::IncompletePacket;
+    } else if (error) {
+        return error;
+    }
+
+    size_t length;
+    error = Dynamixel::checkStatusHeader(statusPacket, id, length);
+    if (error) {
+        return error;
+    }
+    if (length != StatusPacketSize - 5) {
+        // E.g. a unit that reports an instruction error without parameters.
+        state.errors[index] = statusPacket[4];
+        return Errc::UnexpectedLength;
+    }
+
+    transport->read(boost::asio::buffer(statusPacket + 5, length), deadline, error);
+    if (error == boost::asio::error::timed_out) {
+        return Errc::IncompletePacket;
+    } else if (error) {
+        return error;
+    }
+    state.received[index] = Clock::now();
+
+    error = Dynamixel::checkStatusChecksum(statusPacket, StatusPacketSize);
+    if (error) {
+        return error;
+    }
+
+    const byte *data = statusPacket + 5;
+    state.errors[index] = statusPacket[4];
+    state.position[index] = static_cast<uint16_t>(data[0] | (data[1] << 8u));
+    state.speed[index] = static_cast<uint16_t>(data[2] | (data[3] << 8u));
+    state.load[index] = static_cast<uint16_t>(data[4] | (data[5] << 8u));
+    state.voltage[index] = data[6];
+    state.temperature[index] = data[7];
+
+    return {};
+}
@@ -0,0 +1,126 @@
+#include "dynamixel/ReplayTransport.h"
+
+#include <boost/asio/error.hpp>
+#include <cstring>
+#include <thread>
+
+using namespace goliath::dynamixel;
+
+ReplayTransport::ReplayTransport(std::vector<CapturedPacket> packets, double speed)
+        : packets(std::move(packets)), speed(speed) {
+}
+
+size_t ReplayTransport::write(boost::asio::const_buffer data, boost::system::error_code &error) {
+    error = boost::system::error_code();
+
+    while (position < packets.size() && packets[position].direction != CaptureRecord::Direction::Transmit) {
+        ++position;
+    }
+    if (position == packets.size()) {
+        // Nothing left to replay; the write goes unanswered.
+        return data.size();
+    }
+
+    const CapturedPacket &transmission = packets[position++];
+    if (transmission.data.size() != data.size() ||
+        std::memcmp(transmission.data.data(), data.data(), data.size()) != 0) {
+        ++mismatches;
+    }
+
+    // Schedule everything that was received up to the next transmission.
+    auto now = Clock::now();
+    for (; position < packets.size() && packets[position].direction == CaptureRecord::Direction::Receive;
+           ++position) {
+        const CapturedPacket &reception = packets[position];
+        auto due = now + scale(reception.timestamp - transmission.timestamp);
+        for (byte value : reception.data) {
+            pending.push_back({due, value});
+        }
+    }
+
+    return data.size();
+}
+
+size_t ReplayTransport::read(boost::asio::mutable_buffer buffer, Clock::time_point deadline,
+                             boost::system::error_code &error) {
+    auto first = static_cast<byte *>(buffer.data());
+    size_t size = buffer.size();
+    size_t bytesReceived = 0;
+
+    while (bytesReceived < size) {
+        auto now = Clock::now();
+        while (bytesReceived < size && !pending.empty() && pending.front().due <= now) {
+            first[bytesReceived++] = pending.front().value;
+            pending.pop_front();
+        }
+
+        if (bytesReceived == size) {
+            break;
+        }
+
+        if (pending.empty() || pending.front().due > deadline) {
+            if (speed > 0) {
+                std::this_thread::sleep_until(deadline);
+            }
+            error = boost::asio::error::timed_out;
+            return bytesReceived;
+        }
+
+        std::this_thread::sleep_until(pending.front().due);
+    }
+
+    error = boost::system::error_code();
+    return bytesReceived;
+}
+
+void ReplayTransport::flush(FlushType what) {
+    if (what != FlushType::Send) {
+        pending.clear();
+    }
+}
+
+size_t ReplayTransport::getMismatches() const {
+    return mismatches;
+}
+
+bool ReplayTransport::isFinished() const {
+    for (size_t i = position; i < packets.size(); ++i) {
+        if (packets[i].direction == CaptureRecord::Direction::Transmit) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+size_t ReplayTransport::transmit(const std::vector<CapturedPacket> &packets, Transport &transport, double speed) {
+    size_t transmitted = 0;
+    auto start = Clock::now();
+    Clock::time_point origin;
+
+    for (const auto &packet : packets) {
+        if (packet.direction != CaptureRecord::Direction::Transmit) {
+            continue;
+        }
+
+        if (transmitted == 0) {
+            origin = packet.timestamp;
+        } else if (speed > 0) {
+            auto delay = std::chrono::duration_cast<Clock::duration>((packet.timestamp - origin) / speed);
+            std::this_thread::sleep_until(start + delay);
+        }
+
+        transport.write(packet.data);
+        ++transmitted;
+    }
+
+    return transmitted;
+}
+
+Transport::Clock::duration ReplayTransport::scale(Clock::duration delay) const {
+    if (speed <= 0) {
+        return Clock::duration::zero();
+    }
+
+    return std::chrono::duration_cast<Clock::duration>(delay / speed);
+}
@@ -0,0 +1,44 @@
+#include "dynamixel/Result.h"
+
+#include <string>
+
+using namespace goliath::dynamixel;
+
+namespace {
+    class ErrorCategory : public boost::system::error_category {
+    public:
+        const char *name() const noexcept override {
+            return "dynamixel";
+        }
+
+        std::string message(int value) const override {
+            switch (static_cast<Errc>(value)) {
+                case Errc::Timeout:
+                    return "No status packet received before the timeout";
+                case Errc::IncompletePacket:
+                    return "Incomplete status packet";
+                case Errc::WrongHeader:
+                    return "Wrong header; should be equal to [0xFF, 0xFF]";
+                case Errc::WrongId:
+                    return "Received status packet of the wrong id";
+                case Errc::InvalidChecksum:
+                    return "Invalid checksum";
+                case Errc::UnexpectedLength:
+                    return "Status packet has an unexpected number of parameters";
+                case Errc::BusContention:
+                    return "Bus contention; the transmitted bytes weren't echoed back unchanged";
+            }
+
+            return "Unknown error";
+        }
+    };
+}
+
+const boost::system::error_category &goliath::dynamixel::getErrorCategory() {
+    static ErrorCategory category;
+    return category;
+}
+
+boost::system::error_code goliath::dynamixel::make_error_code(Errc error) {
+    return {static_cast<int>(error), getErrorCategory()};
+}
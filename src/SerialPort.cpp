@@ -1,9 +1,13 @@
 #include "dynamixel/SerialPort.h"
 
+#include <cerrno>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+
 using namespace goliath::dynamixel;
 
-SerialPort::SerialPort() : port(std::make_unique<boost::asio::serial_port>(io)),
-                           timeout(std::chrono::milliseconds(50)) {
+SerialPort::SerialPort() : port(std::make_unique<boost::asio::serial_port>(io)) {
 }
 
 bool SerialPort::connect(const std::string &device, unsigned int baud) {
@@ -22,72 +26,98 @@ void SerialPort::close() {
     port->close();
 }
 
+void SerialPort::setBaudRate(unsigned int baud) {
+    port->set_option(boost::asio::serial_port_base::baud_rate(baud));
+}
+
+unsigned int SerialPort::getBaudRate() const {
+    boost::asio::serial_port_base::baud_rate baud;
+    port->get_option(baud);
+    return baud.value();
+}
+
 SerialPort::~SerialPort() {
     if (port->is_open()) {
         close();
     }
 }
 
-void SerialPort::setTimeout(const TimerType::duration &t) {
-    timeout = t;
+size_t SerialPort::write(boost::asio::const_buffer data, boost::system::error_code &error) {
+    return boost::asio::write(*port, boost::asio::buffer(data), error);
 }
 
-size_t SerialPort::write(const std::vector<unsigned char> &data) {
-    flush(FlushType::Receive);
-
-    return boost::asio::write(*port, boost::asio::buffer(data));
+size_t SerialPort::write(const std::vector<boost::asio::const_buffer> &buffers, boost::system::error_code &error) {
+    // Asio gathers the buffer sequence into writev() calls on the descriptor.
+    return boost::asio::write(*port, buffers, error);
 }
 
 void SerialPort::flush(FlushType what) {
-    if (::tcflush(port->native_handle(), static_cast<int>(what)) != 0) {
+    int queue = TCIOFLUSH;
+    if (what == FlushType::Receive) {
+        queue = TCIFLUSH;
+    } else if (what == FlushType::Send) {
+        queue = TCOFLUSH;
+    }
+
+    if (::tcflush(port->native_handle(), queue) != 0) {
         throw boost::system::system_error(errno, boost::asio::error::get_system_category());
     }
 }
 
-std::vector<unsigned char> SerialPort::read(size_t size) {
-    // Allocate a vector with the desired size
-    std::vector<unsigned char> result(size);
+boost::asio::io_service &SerialPort::getIoService() {
+    return io;
+}
 
-    readWithTimeout(boost::asio::buffer(result)); // Fill it with values
-    return result;
+boost::asio::serial_port &SerialPort::getSerialPort() {
+    return *port;
 }
 
-template<typename MutableBufferSequence>
-void SerialPort::readWithTimeout(const MutableBufferSequence &buffer) {
-    size_t bytesReceived = 0;
-    boost::optional<boost::system::error_code> timerResult;
-    TimerType timer(io);
-    timer.expires_from_now(timeout);
-    timer.async_wait([&timerResult](const boost::system::error_code &error) {
-        timerResult = error;
-    });
-
-    boost::optional<boost::system::error_code> readResult;
-    boost::asio::async_read(*port, buffer, [&readResult, &bytesReceived](const boost::system::error_code &error, size_t bytes) {
-        readResult = error;
-        bytesReceived = bytes;
-    });
-
-    io.reset();
-    while (io.run_one()) {
-        if (readResult) {
-            timer.cancel();
-        } else if (timerResult) {
-            port->cancel();
-        }
+size_t SerialPort::read(boost::asio::mutable_buffer buffer, Clock::time_point deadline,
+                        boost::system::error_code &error) {
+    error = boost::system::error_code();
+    if (!port->is_open()) {
+        error = boost::asio::error::bad_descriptor;
+        return 0;
     }
 
-    if (readResult && *readResult != boost::system::errc::success) {
-        auto first = boost::asio::buffer_cast<unsigned char *>(buffer);
-        auto last = first + bytesReceived;
+    auto *data = static_cast<unsigned char *>(buffer.data());
+    size_t size = buffer.size();
+    size_t bytesReceived = 0;
 
-        std::string bufferStr;
-        for (auto it = first; it != last; ++it) {
-            bufferStr += (boost::format("0x%02X ") % static_cast<int>(*it)).str();
+    pollfd descriptor{};
+    descriptor.fd = port->native_handle();
+    descriptor.events = POLLIN;
+
+    while (bytesReceived < size) {
+        auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - Clock::now()).count();
+        if (remaining <= 0) {
+            error = boost::asio::error::timed_out;
+            break;
         }
-        BOOST_LOG_TRIVIAL(debug) << "Buffer: " << bufferStr << " Bytes received: " << bytesReceived << ", expected: "
-                                 << boost::asio::buffer_size(buffer);
 
-        throw boost::system::system_error(*readResult);
+        timespec timeout{};
+        timeout.tv_sec = static_cast<time_t>(remaining / 1000000000);
+        timeout.tv_nsec = static_cast<long>(remaining % 1000000000);
+        int ready = ::ppoll(&descriptor, 1, &timeout, nullptr);
+        if (ready < 0 && errno != EINTR) {
+            error = boost::system::error_code(errno, boost::asio::error::get_system_category());
+            break;
+        } else if (ready <= 0) {
+            continue;
+        }
+
+        ssize_t bytes = ::read(descriptor.fd, data + bytesReceived, size - bytesReceived);
+        if (bytes > 0) {
+            bytesReceived += static_cast<size_t>(bytes);
+        } else if (bytes < 0 && errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK) {
+            error = boost::system::error_code(errno, boost::asio::error::get_system_category());
+            break;
+        } else if (descriptor.revents & (POLLERR | POLLHUP | POLLNVAL)) {
+            // Readable without data, e.g. an unplugged adapter.
+            error = boost::asio::error::eof;
+            break;
+        }
     }
-}
\ No newline at end of file
+
+    return bytesReceived;
+}
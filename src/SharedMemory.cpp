@@ -0,0 +1,65 @@
+#include "dynamixel/SharedMemory.h"
+
+#include <boost/system/system_error.hpp>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace goliath::dynamixel;
+
+namespace {
+    [[noreturn]] void throwSystemError(int fd) {
+        int error = errno;
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        throw boost::system::system_error(error, boost::system::system_category());
+    }
+}
+
+SharedMemory::SharedMemory(std::string name, Access access, size_t size)
+        : name(std::move(name)), owner(access == Access::Create), mappedSize(size) {
+    int fd;
+    if (owner) {
+        // Start from an empty object, so no reader sees stale contents of a previous run.
+        ::shm_unlink(this->name.c_str());
+        fd = ::shm_open(this->name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+        if (fd < 0 || ::ftruncate(fd, static_cast<off_t>(mappedSize)) != 0) {
+            throwSystemError(fd);
+        }
+    } else {
+        fd = ::shm_open(this->name.c_str(), access == Access::ReadOnly ? O_RDONLY : O_RDWR, 0);
+        struct stat status{};
+        if (fd < 0 || ::fstat(fd, &status) != 0) {
+            throwSystemError(fd);
+        }
+        mappedSize = static_cast<size_t>(status.st_size);
+    }
+
+    int protection = access == Access::ReadOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+    mapping = ::mmap(nullptr, mappedSize, protection, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        throwSystemError(fd);
+    }
+    ::close(fd);
+}
+
+SharedMemory::~SharedMemory() {
+    ::munmap(mapping, mappedSize);
+    if (owner) {
+        ::shm_unlink(name.c_str());
+    }
+}
+
+void *SharedMemory::data() const {
+    return mapping;
+}
+
+size_t SharedMemory::size() const {
+    return mappedSize;
+}
+
+const std::string &SharedMemory::getName() const {
+    return name;
+}
@@ -0,0 +1,84 @@
+#include "dynamixel/StateEstimator.h"
+
+#include "dynamixel/Conversion.h"
+
+using namespace goliath::dynamixel;
+
+StateEstimator::StateEstimator(float alpha, float beta, Clock::duration timeout) : alpha(alpha),
+                                                                                   beta(beta),
+                                                                                   timeout(timeout) {
+}
+
+void StateEstimator::update(uint16_t position, Clock::time_point sampled) {
+    if (!initialized || sampled - time > timeout) {
+        initialize(position, 0.0f, sampled);
+        return;
+    }
+
+    float elapsed = std::chrono::duration<float>(sampled - time).count();
+    if (elapsed <= 0.0f) {
+        return;
+    }
+
+    // Predict with the actual interval between the samples, then correct by the residual.
+    float predicted = this->position + velocity * elapsed;
+    float residual = static_cast<float>(position) - predicted;
+
+    this->position = predicted + alpha * residual;
+    velocity += beta * residual / elapsed;
+    time = sampled;
+}
+
+void StateEstimator::update(uint16_t position, const Dynamixel::Timing &timing) {
+    update(position, timing.sampled());
+}
+
+void StateEstimator::update(const RawState &state, size_t index) {
+    if (!state.valid[index]) {
+        return;
+    }
+
+    Clock::time_point sampled = Dynamixel::Timing{state.transmitted[index], state.received[index]}.sampled();
+    if (!initialized || sampled - time > timeout) {
+        // Bit 10 of the speed is the direction, set being clockwise (decreasing position).
+        uint16_t speed = state.speed[index];
+        float ticksPerSecond = (speed & 0x3FFu) * Conversion::TicksPerSecondPerSpeedUnit;
+        initialize(state.position[index], (speed & 0x400u) != 0 ? -ticksPerSecond : ticksPerSecond, sampled);
+        return;
+    }
+
+    update(state.position[index], sampled);
+}
+
+bool StateEstimator::isInitialized() const {
+    return initialized;
+}
+
+float StateEstimator::getPosition() const {
+    return position;
+}
+
+float StateEstimator::getPosition(Clock::time_point time) const {
+    return position + velocity * std::chrono::duration<float>(time - this->time).count();
+}
+
+float StateEstimator::getVelocity() const {
+    return velocity;
+}
+
+StateEstimator::Clock::time_point StateEstimator::getTime() const {
+    return time;
+}
+
+void StateEstimator::reset() {
+    initialized = false;
+    position = 0.0f;
+    velocity = 0.0f;
+}
+
+void StateEstimator::initialize(float position, float velocity, Clock::time_point sampled) {
+    initialized = true;
+    this->position = position;
+    this->velocity = velocity;
+    time = sampled;
+}
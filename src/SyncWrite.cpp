@@ -0,0 +1,95 @@
+#include "dynamixel/SyncWrite.h"
+
+#include <stdexcept>
+#include <string>
+
+using namespace goliath::dynamixel;
+
+SyncWrite::SyncWrite(Dynamixel::Address address, size_t length) : address(address), length(length),
+                                                                  maxUnits(getMaxUnits(length)) {
+    if (maxUnits == 0) {
+        throw std::invalid_argument("Sync write can't write " + std::to_string(length) + " bytes per unit");
+    }
+}
+
+size_t SyncWrite::getMaxUnits(size_t length) {
+    // The parameters are the address and length, followed by [ID, data...] per unit.
+    return (Dynamixel::MaxParameters - 2) / (length + 1);
+}
+
+void SyncWrite::add(byte id, const std::vector<byte> &data) {
+    if (data.size() != length) {
+        throw std::invalid_argument("Sync write expects " + std::to_string(length) + " bytes per unit");
+    }
+    checkRoom();
+
+    params.push_back(id);
+    params.insert(params.end(), data.begin(), data.end());
+}
+
+void SyncWrite::add(byte id, uint16_t value) {
+    if (length != 2) {
+        throw std::invalid_argument("Sync write expects " + std::to_string(length) + " bytes per unit");
+    }
+    checkRoom();
+
+    params.push_back(id);
+    params.push_back(static_cast<byte>(value));
+    params.push_back(static_cast<byte>(value >> 8u));
+}
+
+void SyncWrite::add(const std::vector<uint8_t> &ids, const uint16_t *values) {
+    if (size() + ids.size() > maxUnits) {
+        throw std::invalid_argument("Sync write of " + std::to_string(length) + " bytes takes at most " +
+                                    std::to_string(maxUnits) + " units");
+    }
+
+    params.reserve(params.size() + ids.size() * (length + 1));
+    for (size_t i = 0; i < ids.size(); ++i) {
+        add(ids[i], values[i]);
+    }
+}
+
+size_t SyncWrite::size() const {
+    return params.size() / (length + 1);
+}
+
+bool SyncWrite::empty() const {
+    return params.empty();
+}
+
+void SyncWrite::clear() {
+    params.clear();
+}
+
+std::vector<SyncWrite::byte> SyncWrite::getPacket() const {
+    // The structure of the parameters is as the following:
+    // +-------+------+---+-------+-------+---+-------+---+
+    // |ADDRESS|LENGTH|ID1|DATA1-1|...    |ID2|DATA2-1|...|
+    // +-------+------+---+-------+-------+---+-------+---+
+    std::vector<byte> data;
+    data.reserve(params.size() + 2);
+    data.push_back(static_cast<byte>(address));
+    data.push_back(static_cast<byte>(length));
+    data.insert(data.end(), params.begin(), params.end());
+
+    return Dynamixel::getInstructionPacket(Dynamixel::BroadcastId, Dynamixel::Instruction::SyncWrite, data);
+}
+
+void SyncWrite::checkRoom() const {
+    if (size() == maxUnits) {
+        throw std::invalid_argument("Sync write of " + std::to_string(length) + " bytes takes at most " +
+                                    std::to_string(maxUnits) + " units");
+    }
+}
+
+void SyncWrite::send(Transport &port) const {
+    if (empty()) {
+        return;
+    }
+
+    std::vector<byte> packet = getPacket();
+
+    std::lock_guard<std::recursive_mutex> lock(port.getBusMutex());
+    port.write(packet);
+}
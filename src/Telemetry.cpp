@@ -0,0 +1,150 @@
+#include "dynamixel/Telemetry.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+using namespace goliath::dynamixel;
+
+namespace {
+    constexpr size_t CacheLineSize = 64;
+
+    uint64_t toNanoseconds(std::chrono::steady_clock::time_point time) {
+        return static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count());
+    }
+
+    std::chrono::steady_clock::time_point fromNanoseconds(uint64_t nanoseconds) {
+        return std::chrono::steady_clock::time_point(
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::nanoseconds(nanoseconds)));
+    }
+
+    size_t getSlotSize(size_t servoCount) {
+        size_t size = sizeof(TelemetrySlot) + servoCount * sizeof(TelemetryServo);
+        return (size + CacheLineSize - 1) / CacheLineSize * CacheLineSize;
+    }
+
+    template<typename Header>
+    auto slotAt(Header *header, uint64_t sample) {
+        using Byte = std::conditional_t<std::is_const_v<Header>, const char, char>;
+        using Slot = std::conditional_t<std::is_const_v<Header>, const TelemetrySlot, TelemetrySlot>;
+
+        auto *slots = reinterpret_cast<Byte *>(header + 1);
+        return reinterpret_cast<Slot *>(slots + (sample % header->capacity) * header->slotSize);
+    }
+}
+
+TelemetryPublisher::TelemetryPublisher(const std::string &name, size_t servoCount, size_t capacity)
+        : memory(name, SharedMemory::Access::Create, sizeof(TelemetryHeader) + capacity * getSlotSize(servoCount)) {
+    if (capacity == 0) {
+        throw std::invalid_argument("A telemetry ring needs at least one slot");
+    }
+
+    // The object is created zero-filled, so every slot starts with sequence 0 ("never written").
+    header = new(memory.data()) TelemetryHeader();
+    header->version = TelemetryHeader::CurrentVersion;
+    header->slotSize = static_cast<uint32_t>(getSlotSize(servoCount));
+    header->capacity = static_cast<uint32_t>(capacity);
+    header->servoCount = static_cast<uint32_t>(servoCount);
+    std::memcpy(header->magic, TelemetryHeader::Magic, sizeof(header->magic));
+}
+
+void TelemetryPublisher::publish(const RawState &state, Clock::time_point time) {
+    uint64_t sample = header->published.load(std::memory_order_relaxed);
+    TelemetrySlot *slot = slotAt(header, sample);
+
+    // Readers that see an odd sequence, or a different one after copying, know the slot is being rewritten.
+    slot->sequence.store(2 * sample + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot->timestamp = toNanoseconds(time);
+
+    auto *servos = reinterpret_cast<TelemetryServo *>(slot + 1);
+    size_t size = std::min<size_t>(state.size(), header->servoCount);
+    for (size_t i = 0; i < size; ++i) {
+        servos[i].id = state.ids[i];
+        servos[i].error = state.errors[i];
+        servos[i].valid = state.valid[i];
+        servos[i].voltage = state.voltage[i];
+        servos[i].temperature = state.temperature[i];
+        servos[i].position = state.position[i];
+        servos[i].speed = state.speed[i];
+        servos[i].load = state.load[i];
+        servos[i].transmitted = toNanoseconds(state.transmitted[i]);
+        servos[i].received = toNanoseconds(state.received[i]);
+    }
+    std::memset(servos + size, 0, (header->servoCount - size) * sizeof(TelemetryServo));
+
+    slot->sequence.store(2 * (sample + 1), std::memory_order_release);
+    header->published.store(sample + 1, std::memory_order_release);
+}
+
+uint64_t TelemetryPublisher::getPublished() const {
+    return header->published.load(std::memory_order_relaxed);
+}
+
+TelemetryReader::TelemetryReader(const std::string &name) : memory(name, SharedMemory::Access::ReadOnly) {
+    header = static_cast<const TelemetryHeader *>(memory.data());
+
+    if (memory.size() < sizeof(TelemetryHeader) ||
+        std::memcmp(header->magic, TelemetryHeader::Magic, sizeof(header->magic)) != 0 ||
+        header->version != TelemetryHeader::CurrentVersion ||
+        header->slotSize != getSlotSize(header->servoCount) || header->capacity == 0 ||
+        sizeof(TelemetryHeader) + static_cast<size_t>(header->capacity) * header->slotSize > memory.size()) {
+        throw std::runtime_error("Unsupported telemetry region: " + name);
+    }
+}
+
+uint64_t TelemetryReader::getPublished() const {
+    return header->published.load(std::memory_order_acquire);
+}
+
+size_t TelemetryReader::getCapacity() const {
+    return header->capacity;
+}
+
+size_t TelemetryReader::getServoCount() const {
+    return header->servoCount;
+}
+
+bool TelemetryReader::read(uint64_t sample, RawState &state, Clock::time_point &time) const {
+    const TelemetrySlot *slot = slotAt(header, sample);
+
+    uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+    if (sequence != 2 * (sample + 1)) {
+        return false;
+    }
+
+    state.resize(header->servoCount);
+    const auto *servos = reinterpret_cast<const TelemetryServo *>(slot + 1);
+    for (size_t i = 0; i < header->servoCount; ++i) {
+        state.ids[i] = servos[i].id;
+        state.errors[i] = servos[i].error;
+        state.valid[i] = servos[i].valid;
+        state.voltage[i] = servos[i].voltage;
+        state.temperature[i] = servos[i].temperature;
+        state.position[i] = servos[i].position;
+        state.speed[i] = servos[i].speed;
+        state.load[i] = servos[i].load;
+        state.transmitted[i] = fromNanoseconds(servos[i].transmitted);
+        state.received[i] = fromNanoseconds(servos[i].received);
+    }
+    time = fromNanoseconds(slot->timestamp);
+
+    // The copy is only consistent if the publisher didn't start rewriting the slot meanwhile.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot->sequence.load(std::memory_order_relaxed) == sequence;
+}
+
+bool TelemetryReader::readLatest(RawState &state, Clock::time_point &time) const {
+    // Only fails if the publisher laps the reader while copying, then the next latest sample is tried.
+    for (uint64_t published = getPublished(); published > 0; published = getPublished()) {
+        if (read(published - 1, state, time)) {
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,52 @@
+#include "dynamixel/TransmitBatch.h"
+
+using namespace goliath::dynamixel;
+
+TransmitBatch::TransmitBatch(std::shared_ptr<Transport> port) : port(std::move(port)) {
+}
+
+void TransmitBatch::add(byte id, Dynamixel::Instruction instruction, const std::vector<byte> &data) {
+    add(Dynamixel::getInstructionPacket(id, instruction, data));
+}
+
+void TransmitBatch::add(std::vector<byte> packet) {
+    // Moving the packet keeps its storage, so the buffer stays valid when `packets` grows.
+    packets.push_back(std::move(packet));
+    buffers.emplace_back(boost::asio::buffer(packets.back()));
+}
+
+void TransmitBatch::add(boost::asio::const_buffer packet) {
+    buffers.push_back(packet);
+}
+
+size_t TransmitBatch::size() const {
+    return buffers.size();
+}
+
+bool TransmitBatch::empty() const {
+    return buffers.empty();
+}
+
+void TransmitBatch::clear() {
+    packets.clear();
+    buffers.clear();
+}
+
+size_t TransmitBatch::send(bool expectReply) {
+    if (buffers.empty()) {
+        return 0;
+    }
+
+    size_t written;
+    {
+        std::lock_guard<std::recursive_mutex> lock(port->getBusMutex());
+        if (expectReply) {
+            port->flush(Transport::FlushType::Receive);
+        }
+
+        written = port->write(buffers);
+    }
+    clear();
+
+    return written;
+}
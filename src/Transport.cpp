@@ -0,0 +1,72 @@
+#include "dynamixel/Transport.h"
+
+#include <boost/system/system_error.hpp>
+
+using namespace goliath::dynamixel;
+
+Transport::Transport() : timeout(std::chrono::milliseconds(50)) {
+}
+
+size_t Transport::write(const std::vector<boost::asio::const_buffer> &buffers, boost::system::error_code &error) {
+    size_t written = 0;
+    for (const auto &buffer : buffers) {
+        written += write(buffer, error);
+        if (error) {
+            break;
+        }
+    }
+
+    return written;
+}
+
+size_t Transport::write(boost::asio::const_buffer data) {
+    boost::system::error_code error;
+    size_t written = write(data, error);
+    if (error) {
+        throw boost::system::system_error(error);
+    }
+
+    return written;
+}
+
+size_t Transport::write(const std::vector<byte> &data) {
+    return write(boost::asio::buffer(data));
+}
+
+size_t Transport::write(const std::vector<boost::asio::const_buffer> &buffers) {
+    boost::system::error_code error;
+    size_t written = write(buffers, error);
+    if (error) {
+        throw boost::system::system_error(error);
+    }
+
+    return written;
+}
+
+void Transport::read(boost::asio::mutable_buffer buffer, Clock::time_point deadline) {
+    boost::system::error_code error;
+    read(buffer, deadline, error);
+    if (error) {
+        throw boost::system::system_error(error);
+    }
+}
+
+std::vector<Transport::byte> Transport::read(size_t size) {
+    // Allocate a vector with the desired size
+    std::vector<byte> result(size);
+
+    read(boost::asio::buffer(result), Clock::now() + timeout); // Fill it with values
+    return result;
+}
+
+void Transport::setTimeout(const Clock::duration &t) {
+    timeout = t;
+}
+
+Transport::Clock::duration Transport::getTimeout() const {
+    return timeout;
+}
+
+std::recursive_mutex &Transport::getBusMutex() {
+    return busMutex;
+}
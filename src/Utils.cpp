@@ -10,13 +10,32 @@ short Utils::convertFromHL(unsigned char hexL, unsigned char hexH) {
     return (short) ((hexH << 8) + hexL);
 }
 
-unsigned char Utils::checkSum(std::vector<unsigned char> data) {
+unsigned char Utils::checkSum(const std::vector<unsigned char> &data) {
+    return checkSum(data.data(), data.size());
+}
+
+unsigned char Utils::checkSum(const unsigned char *data, size_t size) {
     int cs = 0;
 
     // Skip first 2 items (padding)
-    for (std::size_t i = 2; i < data.size(); i++) {
+    for (std::size_t i = 2; i < size; i++) {
         cs += data[i];
     }
 
     return (unsigned char) ~cs;
 }
+
+std::string Utils::toHexString(const unsigned char *data, size_t size) {
+    static const char digits[] = "0123456789ABCDEF";
+
+    // Formatted as "0xFF " per byte.
+    std::string result(size * 5, ' ');
+    for (std::size_t i = 0; i < size; i++) {
+        result[i * 5] = '0';
+        result[i * 5 + 1] = 'x';
+        result[i * 5 + 2] = digits[data[i] >> 4];
+        result[i * 5 + 3] = digits[data[i] & 0x0F];
+    }
+
+    return result;
+}
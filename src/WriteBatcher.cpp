@@ -0,0 +1,144 @@
+#include "dynamixel/WriteBatcher.h"
+
+#include "dynamixel/SyncWrite.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+using namespace goliath::dynamixel;
+
+WriteBatcher::WriteBatcher(std::shared_ptr<Transport> port, Clock::duration window) : port(std::move(port)),
+                                                                                       window(window) {
+    if (window > Clock::duration::zero()) {
+        thread = std::thread(&WriteBatcher::run, this);
+    }
+}
+
+WriteBatcher::~WriteBatcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+
+    if (thread.joinable()) {
+        thread.join();
+    }
+    flush();
+}
+
+std::future<void> WriteBatcher::write(byte id, Dynamixel::Address address, const std::vector<byte> &data) {
+    if (data.empty() || SyncWrite::getMaxUnits(data.size()) == 0) {
+        throw std::invalid_argument("Can't batch a write of " + std::to_string(data.size()) + " bytes");
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (batches.empty()) {
+        deadline = Clock::now() + window;
+        changed.notify_all();
+    }
+
+    // Join the last batch to the same range, unless a later batch writes to the unit: the batches are sent in
+    // order, so that batch would be undone.
+    Batch *target = nullptr;
+    size_t index = 0;
+    for (auto it = batches.rbegin(); it != batches.rend(); ++it) {
+        auto unit = std::find(it->ids.begin(), it->ids.end(), id);
+        bool contains = unit != it->ids.end();
+
+        if (it->address == address && it->length == data.size() &&
+            (contains || it->ids.size() < SyncWrite::getMaxUnits(data.size()))) {
+            target = &*it;
+            index = static_cast<size_t>(unit - it->ids.begin());
+            break;
+        }
+        if (contains) {
+            break;
+        }
+    }
+
+    if (!target) {
+        batches.push_back({address, data.size(), {}, {}, {}});
+        target = &batches.back();
+        index = 0;
+    }
+
+    if (index < target->ids.size()) {
+        std::copy(data.begin(), data.end(), target->data.begin() + index * target->length);
+    } else {
+        target->ids.push_back(id);
+        target->data.insert(target->data.end(), data.begin(), data.end());
+    }
+
+    target->promises.emplace_back();
+    return target->promises.back().get_future();
+}
+
+size_t WriteBatcher::flush() {
+    std::lock_guard<std::mutex> sending(sendMutex);
+
+    std::vector<Batch> pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.swap(batches);
+    }
+    send(pending);
+
+    return pending.size();
+}
+
+size_t WriteBatcher::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    size_t size = 0;
+    for (const Batch &batch : batches) {
+        size += batch.promises.size();
+    }
+
+    return size;
+}
+
+WriteBatcher::Clock::duration WriteBatcher::getWindow() const {
+    return window;
+}
+
+void WriteBatcher::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        if (batches.empty()) {
+            changed.wait(lock);
+            continue;
+        }
+        if (Clock::now() < deadline) {
+            changed.wait_until(lock, deadline);
+            continue;
+        }
+
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
+
+void WriteBatcher::send(std::vector<Batch> &batches) {
+    for (Batch &batch : batches) {
+        SyncWrite syncWrite(batch.address, batch.length);
+        for (size_t i = 0; i < batch.ids.size(); ++i) {
+            auto data = batch.data.begin() + i * batch.length;
+            syncWrite.add(batch.ids[i], std::vector<byte>(data, data + batch.length));
+        }
+
+        try {
+            syncWrite.send(*port);
+        } catch (...) {
+            for (std::promise<void> &promise : batch.promises) {
+                promise.set_exception(std::current_exception());
+            }
+            continue;
+        }
+
+        for (std::promise<void> &promise : batch.promises) {
+            promise.set_value();
+        }
+    }
+}
@@ -0,0 +1,107 @@
+#include "dynamixel/CaptureFile.h"
+#include "dynamixel/CaptureTransport.h"
+#include "dynamixel/Dynamixel.h"
+#include "dynamixel/MemoryTransport.h"
+#include "dynamixel/ReplayTransport.h"
+#include "dynamixel/Utils.h"
+
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+using namespace goliath::dynamixel;
+
+namespace {
+    using byte = Dynamixel::byte;
+
+    const char *const CapturePath = "capture-replay.cap";
+
+    // The control table of the simulated unit.
+    std::array<byte, 50> table;
+
+    /**
+     * Answer READ DATA and WRITE DATA as a unit with the ID 1.
+     */
+    void simulate(const byte *data, size_t size, std::vector<byte> &reply) {
+        if (size < 6 || data[2] != 1) {
+            return;
+        }
+
+        auto instruction = static_cast<Dynamixel::Instruction>(data[4]);
+        size_t address = data[5];
+        reply.insert(reply.end(), {0xFF, 0xFF, 1, 2, 0});
+        if (instruction == Dynamixel::Instruction::Read) {
+            reply.insert(reply.end(), table.begin() + address, table.begin() + address + data[6]);
+            reply[3] = static_cast<byte>(2 + data[6]);
+        } else if (instruction == Dynamixel::Instruction::Write) {
+            std::copy(data + 6, data + size - 1, table.begin() + address);
+        }
+        reply.push_back(Utils::checkSum(reply.data(), reply.size()));
+    }
+
+    struct Values {
+        int goalPosition;
+        int presentTemperature;
+        std::vector<byte> controlTable;
+    };
+
+    /**
+     * Talk to the unit: a write, two reads and a read whose status packet spans several capture records.
+     */
+    Values exercise(const std::shared_ptr<Transport> &transport, short goalPosition) {
+        Dynamixel servo(1, transport);
+        servo.setGoalPosition(goalPosition);
+
+        Values values;
+        values.goalPosition = servo.getGoalPosition();
+        values.presentTemperature = servo.getPresentTemperature();
+        values.controlTable = servo.tryReadBlock(Dynamixel::Address::ModelNumber, table.size()).value();
+
+        return values;
+    }
+
+    bool check(bool condition, const char *message) {
+        if (!condition) {
+            std::cerr << "FAILED: " << message << std::endl;
+        }
+
+        return condition;
+    }
+}
+
+int main() {
+    for (size_t i = 0; i < table.size(); ++i) {
+        table[i] = static_cast<byte>(i * 7);
+    }
+
+    Values recorded;
+    {
+        auto writer = std::make_shared<CaptureWriter>(CapturePath, 64);
+        auto bus = std::make_shared<MemoryTransport>(simulate);
+        recorded = exercise(std::make_shared<CaptureTransport>(bus, writer), 300);
+    }
+
+    std::vector<CapturedPacket> packets = CaptureReader(CapturePath).packets();
+    std::remove(CapturePath);
+
+    // Four transactions, whose status packets are received as the header and the rest.
+    bool passed = check(packets.size() == 12, "every transmission and reception is captured");
+
+    auto replay = std::make_shared<ReplayTransport>(packets, 0.0);
+    Values replayed = exercise(replay, 300);
+    passed &= check(replay->getMismatches() == 0, "the replayed transmissions match the capture");
+    passed &= check(replay->isFinished(), "the whole capture is replayed");
+    passed &= check(replayed.goalPosition == recorded.goalPosition && replayed.goalPosition == 300,
+                    "the goal position is replayed");
+    passed &= check(replayed.presentTemperature == recorded.presentTemperature,
+                    "the present temperature is replayed");
+    passed &= check(replayed.controlTable == recorded.controlTable, "the control table is replayed");
+
+    // A different goal position is still answered as captured, but counted as a mismatch.
+    auto diverging = std::make_shared<ReplayTransport>(packets, 0.0);
+    exercise(diverging, 301);
+    passed &= check(diverging->getMismatches() == 1, "a diverging transmission is counted");
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,185 @@
+#include "dynamixel/AllocationCounter.h"
+#include "dynamixel/Dynamixel.h"
+#include "dynamixel/RealTimeWorker.h"
+#include "dynamixel/SerialPort.h"
+#include "dynamixel/Utils.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fcntl.h>
+#include <iostream>
+#include <poll.h>
+#include <thread>
+#include <unistd.h>
+
+GOLIATH_DYNAMIXEL_ALLOCATION_HOOK()
+
+using namespace goliath::dynamixel;
+
+namespace {
+    using byte = Dynamixel::byte;
+
+    constexpr uint64_t Cycles = 500;
+
+    // Tells ctest that the test was skipped, see SKIP_RETURN_CODE.
+    constexpr int Skipped = 77;
+
+    /**
+     * Units on the master side of a pseudo terminal, so the worker runs on a real `SerialPort`. Every READ DATA is
+     * answered as a unit whose control table holds its ID at every address, except that some reads go unanswered
+     * and some replies have a wrong checksum; SYNC WRITEs aren't answered.
+     */
+    class SimulatedBus {
+    public:
+        explicit SimulatedBus(int master) : master(master), thread([this] { run(); }) {
+        }
+
+        ~SimulatedBus() {
+            stopping = true;
+            thread.join();
+        }
+
+        uint64_t getFaults() const {
+            return faults.load();
+        }
+
+    private:
+        int master;
+        std::atomic<bool> stopping{false};
+        std::atomic<uint64_t> faults{0};
+        uint64_t reads = 0;
+        std::thread thread;
+
+        void run() {
+            std::vector<byte> received;
+            byte data[256];
+            pollfd descriptor{master, POLLIN, 0};
+
+            while (!stopping) {
+                if (::poll(&descriptor, 1, 10) <= 0) {
+                    continue;
+                }
+                ssize_t bytes = ::read(master, data, sizeof(data));
+                if (bytes <= 0) {
+                    continue;
+                }
+                received.insert(received.end(), data, data + bytes);
+
+                // [0xFF, 0xFF, id, length, instruction, parameters..., checksum]
+                while (received.size() >= 4) {
+                    if (received[0] != 0xFF || received[1] != 0xFF) {
+                        received.erase(received.begin());
+                        continue;
+                    }
+
+                    size_t size = 4 + received[3];
+                    if (received.size() < size) {
+                        break;
+                    }
+                    answer(received.data(), size);
+                    received.erase(received.begin(), received.begin() + size);
+                }
+            }
+        }
+
+        void answer(const byte *packet, size_t size) {
+            if (size < 8 || packet[4] != static_cast<byte>(Dynamixel::Instruction::Read)) {
+                return;
+            }
+
+            ++reads;
+            if (reads % 7 == 3) {
+                // Stay silent, so the read times out.
+                ++faults;
+                return;
+            }
+
+            byte id = packet[2];
+            byte length = packet[6];
+            std::vector<byte> reply = {0xFF, 0xFF, id, static_cast<byte>(length + 2), 0};
+            reply.insert(reply.end(), length, id);
+            reply.push_back(Utils::checkSum(reply.data(), reply.size()));
+            if (reads % 11 == 5) {
+                reply.back() ^= 0xFFu;
+                ++faults;
+            }
+
+            if (::write(master, reply.data(), reply.size()) != static_cast<ssize_t>(reply.size())) {
+                std::cerr << "Couldn't answer the read" << std::endl;
+            }
+        }
+    };
+
+    bool check(bool condition, const char *message) {
+        if (!condition) {
+            std::cerr << "FAILED: " << message << std::endl;
+        }
+
+        return condition;
+    }
+}
+
+int main() {
+    int master = ::posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || ::grantpt(master) != 0 || ::unlockpt(master) != 0) {
+        std::cerr << "No pseudo terminals available" << std::endl;
+        return Skipped;
+    }
+
+    auto port = std::make_shared<SerialPort>();
+    if (!port->connect(::ptsname(master), 1000000)) {
+        return EXIT_FAILURE;
+    }
+    port->setTimeout(std::chrono::milliseconds(2));
+
+    RealTimeWorker::Config config;
+    config.period = std::chrono::microseconds(500);
+    config.lockMemory = false;
+    config.warmupCycles = 50;
+
+    std::vector<byte> ids = {1, 2, 3, 4};
+    RealTimeWorker::Statistics statistics;
+    RawState state;
+    bool completed;
+    uint64_t faults;
+    {
+        SimulatedBus bus(master);
+        RealTimeWorker worker(port, ids, config);
+        worker.start();
+
+        // Keep the goals changing, so every cycle sends a SYNC WRITE too.
+        uint16_t position = 0;
+        while (worker.getStatistics().cycles < config.warmupCycles + Cycles) {
+            for (size_t i = 0; i < ids.size(); ++i) {
+                worker.setGoalPosition(i, position);
+            }
+            position = static_cast<uint16_t>((position + 1) % 1024);
+
+            worker.getState(state);
+            std::this_thread::sleep_for(config.period);
+        }
+        worker.stop();
+
+        statistics = worker.getStatistics();
+        completed = worker.getState(state);
+        faults = bus.getFaults();
+    }
+    port->close();
+    ::close(master);
+
+    std::cout << statistics.cycles << " cycles, " << statistics.errors << " errors (" << faults << " injected), "
+              << statistics.allocations << " allocations, " << statistics.locks << " locks" << std::endl;
+
+    bool passed = check(AllocationCounter::isInstalled(), "the hook is installed");
+    passed &= check(statistics.allocations == 0, "the loop doesn't allocate after the warmup");
+    passed &= check(statistics.locks == 0, "the loop doesn't lock after the warmup");
+    passed &= check(faults > 0 && statistics.errors >= faults, "timeouts and corrupt replies are counted");
+    passed &= check(completed, "a cycle has completed");
+    for (size_t i = 0; i < ids.size(); ++i) {
+        passed &= check(state.ids[i] == ids[i] && (!state.valid[i] || state.position[i] == (ids[i] | ids[i] << 8u)),
+                        "the state of every unit is read");
+    }
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}